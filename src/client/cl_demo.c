@@ -46,9 +46,7 @@ static void Cl_WriteDemoHeader(void) {
   for (int32_t i = 0; i < MAX_CONFIG_STRINGS; i++) {
     if (*cl.config_strings[i] != '\0') {
       if (msg.size + q_strlen(cl.config_strings[i]) + 32 > msg.max_size) { // write it out
-        const int32_t len = LittleLong((int32_t) msg.size);
-        Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-        Fs_Write(cls.demo_file, msg.data, msg.size, 1);
+        Demo_WriteMessage(cls.demo_file, msg.data, msg.size, cl.frame.time);
         msg.size = 0;
       }
 
@@ -66,9 +64,7 @@ static void Cl_WriteDemoHeader(void) {
     }
 
     if (msg.size + 64 > msg.max_size) { // write it out
-      const int32_t len = LittleLong((int32_t) msg.size);
-      Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-      Fs_Write(cls.demo_file, msg.data, msg.size, 1);
+      Demo_WriteMessage(cls.demo_file, msg.data, msg.size, cl.frame.time);
       msg.size = 0;
     }
 
@@ -79,19 +75,17 @@ static void Cl_WriteDemoHeader(void) {
   Net_WriteByte(&msg, SV_CMD_CBUF_TEXT);
   Net_WriteString(&msg, "precache 0\n");
 
-  // write it to the demo file
+  // write it to the demo file, and flush it so that it seeds the compression dictionary
 
-  const int32_t len = LittleLong((int32_t) msg.size);
-
-  Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-  Fs_Write(cls.demo_file, msg.data, msg.size, 1);
+  Demo_WriteMessage(cls.demo_file, msg.data, msg.size, cl.frame.time);
+  Demo_Flush(cls.demo_file);
 
   Com_Debug(DEBUG_CLIENT, "Demo started\n");
   // the rest of the demo file will be individual frames
 }
 
 /**
- * @brief Dumps the current net message, prefixed by the length.
+ * @brief Dumps the current net message, prefixed by the length and timecode.
  */
 void Cl_WriteDemoMessage(void) {
 
@@ -99,7 +93,7 @@ void Cl_WriteDemoMessage(void) {
     return;
   }
 
-  if (!Fs_Tell(cls.demo_file)) {
+  if (!Demo_Tell(cls.demo_file)) {
     if (cl.frame.delta_frame_num < 0) {
       Com_Debug(DEBUG_CLIENT, "Received uncompressed frame, writing demo header..\n");
       Cl_WriteDemoHeader();
@@ -109,17 +103,21 @@ void Cl_WriteDemoMessage(void) {
   }
 
   // the first eight bytes are just packet sequencing stuff
-  const int32_t len = LittleLong((int32_t) (net_message.size - 8));
+  const byte *data = net_message.data + 8;
+  const size_t len = net_message.size - 8;
 
-  Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-  Fs_Write(cls.demo_file, net_message.data + 8, len, 1);
+  // uncompressed frames that arrive when one is due become keyframes, so that playback can seek
+  if (cl.frame.delta_frame_num < 0 && Demo_KeyframeDue(cls.demo_file, cl.frame.time)) {
+    Demo_WriteKeyframe(cls.demo_file, data, len, cl.frame.time);
+  } else {
+    Demo_WriteMessage(cls.demo_file, data, len, cl.frame.time);
+  }
 }
 
 /**
  * @brief Stop recording a demo
  */
 void Cl_Stop_f(void) {
-  int32_t len = -1;
 
   if (!cls.demo_file) {
     Com_Print("Not recording a demo\n");
@@ -127,8 +125,7 @@ void Cl_Stop_f(void) {
   }
 
   // finish up
-  Fs_Write(cls.demo_file, &len, sizeof(len), 1);
-  Fs_Close(cls.demo_file);
+  Demo_Close(cls.demo_file);
 
   cls.demo_file = NULL;
   Com_Print("Stopped demo\n");
@@ -168,7 +165,7 @@ void Cl_Record_f(void) {
   }
 
   // open the demo file
-  if (!(cls.demo_file = Fs_OpenWrite(cls.demo_filename))) {
+  if (!(cls.demo_file = Demo_OpenWrite(cls.demo_filename, cl_demo_compress->integer))) {
     Com_Warn("Couldn't open %s\n", cls.demo_filename);
     return;
   }
@@ -32,6 +32,7 @@
 #define QUETOO_GUID_URL "https://giblets.quetoo.org/api/guid"
 
 cvar_t *cl_chat_sound;
+cvar_t *cl_demo_compress;
 cvar_t *cl_draw_counters;
 cvar_t *cl_draw_position;
 cvar_t *cl_draw_net_graph;
@@ -529,6 +530,7 @@ static void Cl_InitLocal(void) {
 
   // register our variables
   cl_chat_sound = Cvar_Add("cl_chat_sound", "misc/chat", CVAR_ARCHIVE, "Path to the sound that is made when a chat message is received");
+  cl_demo_compress = Cvar_Add("cl_demo_compress", "1", CVAR_ARCHIVE, "Compress recorded demos");
   cl_draw_counters = Cvar_Add("cl_draw_counters", "1", CVAR_ARCHIVE, "Draw the speed, fps and pps counters at the bottom-right");
   cl_draw_position = Cvar_Add("cl_draw_position", "0", CVAR_DEVELOPER, "Draw your current position to the screen");
   cl_draw_net_graph = Cvar_Add("cl_draw_net_graph", "1", CVAR_ARCHIVE, "Draw the net graph at the bottom-right");
@@ -24,6 +24,7 @@
 #include "cl_types.h"
 
 extern cvar_t *cl_chat_sound;
+extern cvar_t *cl_demo_compress;
 extern cvar_t *cl_draw_counters;
 extern cvar_t *cl_draw_position;
 extern cvar_t *cl_draw_net_graph;
@@ -192,7 +192,7 @@ static void Cl_ParseBaseline(void) {
   static entity_state_t null_state;
 
   const int16_t number = Net_ReadShort(&net_message);
-  const uint16_t bits = Net_ReadShort(&net_message);
+  const uint16_t bits = Net_ReadVarInt(&net_message);
 
   if (number < 0 || number >= MAX_ENTITIES) {
     Com_Error(ERROR_DROP, "Invalid entity number: %d\n", number);
@@ -752,9 +752,9 @@ typedef struct {
   char demo_filename[MAX_OS_PATH];
 
   /**
-   * @brief The demo file handle.
+   * @brief The demo being recorded.
    */
-  file_t *demo_file;
+  demo_t *demo_file;
 
   /**
    * @brief List of `cl_server_info_t` discovered from all sources.
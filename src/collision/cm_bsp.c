@@ -67,6 +67,7 @@ static bsp_lump_meta_t bsp_lump_meta[BSP_LUMP_LAST] = {
   BSP_LUMP_SIZE_STRUCT(voxels, MAX_BSP_VOXELS_SIZE),
   BSP_LUMP_NUM_STRUCT(light_voxels, MAX_BSP_LIGHT_VOXELS),
   BSP_LUMP_NUM_STRUCT(block_voxels, MAX_BSP_BLOCK_VOXELS),
+  BSP_LUMP_SIZE_STRUCT(vis, MAX_BSP_VIS_SIZE),
 };
 
 /**
@@ -269,6 +270,7 @@ static void Bsp_SwapLeafs(void *lump, const int32_t num) {
   for (int32_t i = 0; i < num; i++) {
 
     leaf->contents = LittleLong(leaf->contents);
+    leaf->cluster = LittleLong(leaf->cluster);
     leaf->bounds = LittleBounds(leaf->bounds);
     leaf->first_leaf_brush = LittleLong(leaf->first_leaf_brush);
     leaf->num_leaf_brushes = LittleLong(leaf->num_leaf_brushes);
@@ -406,6 +408,21 @@ static void Bsp_SwapBlockVoxels(void *lump, const int32_t num) {
   }
 }
 
+/**
+ * @brief Swap function.
+ */
+static void Bsp_SwapVis(void *lump, const int32_t num) {
+
+  bsp_vis_t *vis = (bsp_vis_t *) lump;
+
+  vis->num_clusters = LittleLong(vis->num_clusters);
+
+  for (int32_t i = 0; i < vis->num_clusters; i++) {
+    vis->offsets[i][BSP_VIS_PVS] = LittleLong(vis->offsets[i][BSP_VIS_PVS]);
+    vis->offsets[i][BSP_VIS_PHS] = LittleLong(vis->offsets[i][BSP_VIS_PHS]);
+  }
+}
+
 /**
  * @brief Swap entry point.
  */
@@ -431,6 +448,7 @@ static void Bsp_SwapLump(const bsp_lump_id_t lump_id, void *lump, int32_t count)
     Bsp_SwapVoxels,
     Bsp_SwapLightVoxels,
     Bsp_SwapBlockVoxels,
+    Bsp_SwapVis,
   };
 
   if (swap[lump_id]) {
@@ -27,7 +27,7 @@
  * @brief BSP file identification.
  */
 #define BSP_IDENT (('P' << 24) + ('S' << 16) + ('B' << 8) + 'I') // "IBSP"
-#define BSP_VERSION 81
+#define BSP_VERSION 82
 
 /**
  * @brief BSP file format limits.
@@ -52,6 +52,7 @@
 #define MAX_BSP_VOXELS_SIZE   0x4000000
 #define MAX_BSP_LIGHT_VOXELS  0x800000
 #define MAX_BSP_BLOCK_VOXELS  0x800000
+#define MAX_BSP_VIS_SIZE      0x1000000
 
 /**
  * @brief The BSP block node size.
@@ -97,6 +98,7 @@ typedef enum {
   BSP_LUMP_VOXELS,
   BSP_LUMP_LIGHT_VOXELS,
   BSP_LUMP_BLOCK_VOXELS,
+  BSP_LUMP_VIS,
   BSP_LUMP_LAST
 } bsp_lump_id_t;
 
@@ -449,6 +451,11 @@ typedef struct {
    */
   int32_t contents;
 
+  /**
+   * @brief The visibility cluster of this leaf, or -1 for solid and inline model leafs.
+   */
+  int32_t cluster;
+
   /**
    * @brief The AABB of this leaf used for collision.
    */
@@ -707,6 +714,31 @@ typedef struct {
   box3_t bounds;
 } bsp_voxels_t;
 
+/**
+ * @brief Offsets into the visibility lump for potentially visible and hearable sets.
+ */
+#define BSP_VIS_PVS 0
+#define BSP_VIS_PHS 1
+
+/**
+ * @brief The visibility lump header.
+ * @details Each cluster has a potentially visible set (PVS) and a potentially hearable set
+ * (PHS), stored as run-length compressed bit vectors of `num_clusters` bits. Runs of zero
+ * bytes are encoded as a zero byte followed by the length of the run.
+ */
+typedef struct {
+
+  /**
+   * @brief The count of clusters.
+   */
+  int32_t num_clusters;
+
+  /**
+   * @brief The byte offsets of each cluster's PVS and PHS, from the start of this lump.
+   */
+  int32_t offsets[0][2];
+} bsp_vis_t;
+
 /**
  * @brief BSP file lumps in their native file formats. The data is stored as pointers
  * so that we don't take up an ungodly amount of space.
@@ -903,6 +935,16 @@ typedef struct bsp_file_s {
    */
   int32_t *block_voxels;
 
+  /**
+   * @brief Total size of the visibility lump in bytes.
+   */
+  int32_t vis_size;
+
+  /**
+   * @brief Compressed cluster visibility, or `NULL` if the map was compiled without it.
+   */
+  bsp_vis_t *vis;
+
   /**
    * @brief Bitmask of loaded lump identifiers.
    */
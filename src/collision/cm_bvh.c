@@ -0,0 +1,290 @@
+/*
+ * Copyright(c) 1997-2001 id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quetoo.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "cm_local.h"
+
+/**
+ * @brief The number of bins in which brush centers are sorted when evaluating splits.
+ */
+#define CM_BVH_BINS 12
+
+/**
+ * @brief The maximum number of brushes referenced by a leaf node. Larger sets are split
+ * even when the surface area heuristic would prefer a leaf.
+ */
+#define CM_BVH_MAX_LEAF_BRUSHES 8
+
+/**
+ * @brief The cost of visiting a node, relative to the cost of testing a brush.
+ */
+#define CM_BVH_TRAVERSAL_COST .5f
+
+/**
+ * @brief A bin of brushes whose centers fall within the same slice of a node.
+ */
+typedef struct {
+  /**
+   * @brief The bounds of the brushes in this bin.
+   */
+  box3_t bounds;
+
+  /**
+   * @brief The number of brushes in this bin.
+   */
+  int32_t count;
+} cm_bvh_bin_t;
+
+/**
+ * @return The half surface area of `bounds`, or 0 for null bounds.
+ */
+static float Cm_BvhArea(const box3_t bounds) {
+
+  if (Box3_IsNull(bounds)) {
+    return 0.f;
+  }
+
+  const vec3_t size = Box3_Size(bounds);
+  return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+/**
+ * @return The bin for the given brush center along `axis`.
+ */
+static int32_t Cm_BvhBin(const box3_t centers, int32_t axis, const vec3_t center) {
+
+  const float extent = centers.maxs.xyz[axis] - centers.mins.xyz[axis];
+  const int32_t bin = (int32_t) ((center.xyz[axis] - centers.mins.xyz[axis]) / extent * CM_BVH_BINS);
+
+  return Mini(Maxi(bin, 0), CM_BVH_BINS - 1);
+}
+
+/**
+ * @brief Recursively builds the hierarchy for the `count` brush references at `first`,
+ * partitioning them with the binned surface area heuristic.
+ * @return The node number.
+ */
+static int32_t Cm_InitBvh_r(cm_bsp_t *bsp, int32_t first, int32_t count, int32_t depth) {
+
+  const int32_t node_num = bsp->num_bvh_nodes++;
+  cm_bvh_node_t *node = &bsp->bvh_nodes[node_num];
+
+  int32_t *brushes = bsp->bvh_brushes + first;
+
+  box3_t bounds = Box3_Null(), centers = Box3_Null();
+  for (int32_t i = 0; i < count; i++) {
+    const box3_t b = bsp->brushes[brushes[i]].bounds;
+
+    bounds = Box3_Union(bounds, b);
+    centers = Box3_Append(centers, Box3_Center(b));
+  }
+
+  node->bounds = bounds;
+  node->first = first;
+  node->count = count;
+
+  if (count == 1 || depth == CM_BVH_MAX_DEPTH - 1) {
+    return node_num;
+  }
+
+  const float leaf_cost = count;
+  const float area = Cm_BvhArea(bounds);
+
+  float best_cost = FLT_MAX;
+  int32_t best_axis = -1, best_split = 0;
+
+  for (int32_t axis = 0; axis < 3; axis++) {
+
+    if (centers.maxs.xyz[axis] - centers.mins.xyz[axis] <= 0.f) {
+      continue;
+    }
+
+    cm_bvh_bin_t bins[CM_BVH_BINS];
+    for (int32_t i = 0; i < CM_BVH_BINS; i++) {
+      bins[i] = (cm_bvh_bin_t) { .bounds = Box3_Null() };
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+      const box3_t b = bsp->brushes[brushes[i]].bounds;
+      cm_bvh_bin_t *bin = &bins[Cm_BvhBin(centers, axis, Box3_Center(b))];
+
+      bin->bounds = Box3_Union(bin->bounds, b);
+      bin->count++;
+    }
+
+    // sweep from the right to accumulate the cost of each right hand side
+    float right_costs[CM_BVH_BINS];
+
+    box3_t right = Box3_Null();
+    int32_t right_count = 0;
+
+    for (int32_t i = CM_BVH_BINS - 1; i > 0; i--) {
+      right = Box3_Union(right, bins[i].bounds);
+      right_count += bins[i].count;
+      right_costs[i] = Cm_BvhArea(right) * right_count;
+    }
+
+    // and then from the left to resolve the cost of each split
+    box3_t left = Box3_Null();
+    int32_t left_count = 0;
+
+    for (int32_t i = 1; i < CM_BVH_BINS; i++) {
+      left = Box3_Union(left, bins[i - 1].bounds);
+      left_count += bins[i - 1].count;
+
+      if (left_count == 0 || left_count == count) {
+        continue;
+      }
+
+      const float cost = CM_BVH_TRAVERSAL_COST + (Cm_BvhArea(left) * left_count + right_costs[i]) / area;
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_axis = axis;
+        best_split = i;
+      }
+    }
+  }
+
+  if (best_axis == -1) { // coincident brush centers can not be partitioned
+    return node_num;
+  }
+
+  if (best_cost >= leaf_cost && count <= CM_BVH_MAX_LEAF_BRUSHES) {
+    return node_num;
+  }
+
+  // partition the brush references about the split
+  int32_t i = 0, j = count - 1;
+  while (i <= j) {
+    if (Cm_BvhBin(centers, best_axis, Box3_Center(bsp->brushes[brushes[i]].bounds)) < best_split) {
+      i++;
+    } else {
+      const int32_t brush = brushes[i];
+      brushes[i] = brushes[j];
+      brushes[j--] = brush;
+    }
+  }
+
+  Cm_InitBvh_r(bsp, first, i, depth + 1);
+
+  const int32_t second = Cm_InitBvh_r(bsp, first + i, count - i, depth + 1);
+
+  node = &bsp->bvh_nodes[node_num];
+  node->first = second;
+  node->count = 0;
+
+  return node_num;
+}
+
+/**
+ * @brief Appends the brushes referenced by the leafs beneath `head_node` to the brush
+ * references, skipping those already appended for the same model.
+ */
+static void Cm_InitBvhBrushes(cm_bsp_t *bsp, int32_t head_node, int32_t model, int32_t *marks, int32_t *stack) {
+
+  int32_t depth = 0;
+
+  stack[depth++] = head_node;
+
+  while (depth) {
+    const int32_t num = stack[--depth];
+
+    if (num >= 0) {
+      stack[depth++] = bsp->nodes[num].children[0];
+      stack[depth++] = bsp->nodes[num].children[1];
+      continue;
+    }
+
+    const cm_bsp_leaf_t *leaf = &bsp->leafs[-1 - num];
+    for (int32_t i = 0; i < leaf->num_leaf_brushes; i++) {
+
+      const int32_t brush = bsp->leaf_brushes[leaf->first_leaf_brush + i];
+      if (marks[brush] == model) {
+        continue;
+      }
+
+      marks[brush] = model;
+
+      if (bsp->bvh_brushes) {
+        bsp->bvh_brushes[bsp->num_bvh_brushes] = brush;
+      }
+
+      bsp->num_bvh_brushes++;
+    }
+  }
+}
+
+/**
+ * @brief Builds the brush bounding volume hierarchy of each inline model. The brushes of
+ * each model are those referenced by the leafs beneath its head node.
+ */
+void Cm_InitBvh(cm_bsp_t *bsp) {
+
+  bsp->bvh_roots = Mem_TagMalloc(sizeof(int32_t) * bsp->num_nodes, MEM_TAG_COLLISION);
+  memset(bsp->bvh_roots, 0xff, sizeof(int32_t) * bsp->num_nodes);
+
+  int32_t *marks = Mem_Malloc(sizeof(int32_t) * bsp->num_brushes);
+  memset(marks, 0xff, sizeof(int32_t) * bsp->num_brushes);
+
+  int32_t *stack = Mem_Malloc(sizeof(int32_t) * (bsp->num_nodes + 1));
+
+  // count the brush references of each model, allowing for brushes shared between models
+  bsp->num_bvh_brushes = 0;
+
+  for (int32_t i = 0; i < bsp->num_models; i++) {
+    const int32_t head_node = bsp->models[i].head_node;
+
+    if (head_node < 0 || head_node >= bsp->num_nodes) {
+      continue;
+    }
+
+    Cm_InitBvhBrushes(bsp, head_node, i, marks, stack);
+  }
+
+  bsp->bvh_brushes = Mem_TagMalloc(sizeof(int32_t) * bsp->num_bvh_brushes, MEM_TAG_COLLISION);
+  bsp->bvh_nodes = Mem_TagMalloc(sizeof(cm_bvh_node_t) * bsp->num_bvh_brushes * 2, MEM_TAG_COLLISION);
+
+  bsp->num_bvh_brushes = 0;
+  bsp->num_bvh_nodes = 0;
+
+  memset(marks, 0xff, sizeof(int32_t) * bsp->num_brushes);
+
+  for (int32_t i = 0; i < bsp->num_models; i++) {
+    const int32_t head_node = bsp->models[i].head_node;
+
+    if (head_node < 0 || head_node >= bsp->num_nodes) {
+      continue;
+    }
+
+    const int32_t first = bsp->num_bvh_brushes;
+
+    Cm_InitBvhBrushes(bsp, head_node, i, marks, stack);
+
+    const int32_t count = bsp->num_bvh_brushes - first;
+    if (count) {
+      bsp->bvh_roots[head_node] = Cm_InitBvh_r(bsp, first, count, 0);
+    }
+  }
+
+  Mem_Free(marks);
+  Mem_Free(stack);
+
+  Com_Debug(DEBUG_COLLISION, "%d brush references, %d bvh nodes\n", bsp->num_bvh_brushes, bsp->num_bvh_nodes);
+}
@@ -89,6 +89,7 @@ static void Cm_LoadBspLeafs(cm_bsp_t *bsp) {
 
   for (int32_t i = 0; i < bsp->num_leafs; i++, in++, out++) {
     out->contents = in->contents;
+    out->cluster = in->cluster;
     out->first_leaf_brush = in->first_leaf_brush;
     out->num_leaf_brushes = in->num_leaf_brushes;
   }
@@ -169,6 +170,49 @@ static void Cm_LoadBspBrushes(cm_bsp_t *bsp) {
   }
 }
 
+/**
+ * @brief Packs the brush side planes of `brush` into `planes` in structure-of-arrays layout,
+ * and assigns them to the brush.
+ * @return The number of floats written to `planes`.
+ */
+int32_t Cm_PackBrushPlanes(cm_bsp_brush_t *brush, float *planes) {
+
+  const int32_t len = CM_BRUSH_PLANES(brush->num_brush_sides);
+
+  memset(planes, 0, sizeof(float) * len * 4);
+
+  const cm_bsp_brush_side_t *side = brush->brush_sides;
+  for (int32_t i = 0; i < brush->num_brush_sides; i++, side++) {
+    planes[len * 0 + i] = side->plane->normal.x;
+    planes[len * 1 + i] = side->plane->normal.y;
+    planes[len * 2 + i] = side->plane->normal.z;
+    planes[len * 3 + i] = side->plane->dist;
+  }
+
+  brush->planes = planes;
+
+  return len * 4;
+}
+
+/**
+ * @brief Packs the planes of all brushes into `cm_bsp.brush_planes`, so that the brush sides
+ * may be evaluated several at a time.
+ */
+static void Cm_LoadBspBrushPlanes(cm_bsp_t *bsp) {
+
+  bsp->num_brush_planes = 0;
+
+  for (int32_t i = 0; i < bsp->num_brushes; i++) {
+    bsp->num_brush_planes += CM_BRUSH_PLANES(bsp->brushes[i].num_brush_sides) * 4;
+  }
+
+  float *out = bsp->brush_planes = Mem_TagMalloc(sizeof(float) * bsp->num_brush_planes, MEM_TAG_COLLISION);
+
+  for (int32_t i = 0; i < bsp->num_brushes; i++) {
+    out += Cm_PackBrushPlanes(&bsp->brushes[i], out);
+  }
+}
+
 /**
  * @brief Loads and converts the inline models lump into `cm_bsp`.models`.
  */
@@ -253,6 +297,84 @@ static void Cm_LoadBspVoxels(cm_bsp_t *bsp) {
   }
 }
 
+/**
+ * @brief Decompresses a run-length encoded cluster bit vector.
+ */
+static void Cm_DecompressVis(const byte *in, const byte *end, byte *out, int32_t size) {
+
+  byte *out_end = out + size;
+
+  while (out < out_end) {
+
+    if (in >= end) {
+      Com_Error(ERROR_DROP, "Truncated visibility data\n");
+    }
+
+    if (*in) {
+      *out++ = *in++;
+      continue;
+    }
+
+    if (in + 1 >= end) {
+      Com_Error(ERROR_DROP, "Truncated visibility data\n");
+    }
+
+    const int32_t count = Mini(in[1], (int32_t) (out_end - out));
+    memset(out, 0, count);
+
+    out += count;
+    in += 2;
+  }
+}
+
+/**
+ * @brief Decompresses the visibility lump into the PVS and PHS arrays on the cm_bsp_t.
+ */
+static void Cm_LoadBspVis(cm_bsp_t *bsp) {
+
+  if (!bsp->file->vis) {
+    return;
+  }
+
+  const bsp_vis_t *vis = bsp->file->vis;
+
+  bsp->num_clusters = vis->num_clusters;
+  bsp->cluster_bytes = (bsp->num_clusters + 7) >> 3;
+
+  const size_t header_size = sizeof(bsp_vis_t) + sizeof(vis->offsets[0]) * bsp->num_clusters;
+  if (bsp->num_clusters <= 0 || header_size > (size_t) bsp->file->vis_size) {
+    Com_Error(ERROR_DROP, "Invalid visibility lump\n");
+  }
+
+  const size_t size = (size_t) bsp->num_clusters * bsp->cluster_bytes;
+
+  bsp->pvs = Mem_TagMalloc(size, MEM_TAG_COLLISION);
+  bsp->phs = Mem_TagMalloc(size, MEM_TAG_COLLISION);
+
+  const byte *base = (const byte *) vis;
+  const byte *end = base + bsp->file->vis_size;
+
+  for (int32_t i = 0; i < bsp->num_clusters; i++) {
+
+    const int32_t pvs = vis->offsets[i][BSP_VIS_PVS];
+    const int32_t phs = vis->offsets[i][BSP_VIS_PHS];
+
+    if (pvs < (int32_t) header_size || pvs >= bsp->file->vis_size ||
+        phs < (int32_t) header_size || phs >= bsp->file->vis_size) {
+      Com_Error(ERROR_DROP, "Invalid visibility offsets for cluster %d\n", i);
+    }
+
+    Cm_DecompressVis(base + pvs, end, bsp->pvs + i * bsp->cluster_bytes, bsp->cluster_bytes);
+    Cm_DecompressVis(base + phs, end, bsp->phs + i * bsp->cluster_bytes, bsp->cluster_bytes);
+  }
+
+  for (int32_t i = 0; i < bsp->num_leafs; i++) {
+    if (bsp->leafs[i].cluster >= bsp->num_clusters) {
+      Com_Error(ERROR_DROP, "Leaf %d has invalid cluster %d\n", i, bsp->leafs[i].cluster);
+    }
+  }
+}
+
 /**
  * @brief Lumps we need to load for the CM subsystem.
  */
@@ -266,7 +388,8 @@ static void Cm_LoadBspVoxels(cm_bsp_t *bsp) {
   (1 << BSP_LUMP_BRUSHES) | \
   (1 << BSP_LUMP_BRUSH_SIDES) | \
   (1 << BSP_LUMP_MODELS) | \
-  (1 << BSP_LUMP_VOXELS)
+  (1 << BSP_LUMP_VOXELS) | \
+  (1 << BSP_LUMP_VIS)
 
 /**
  * @brief Loads in the BSP and all sub-models for collision detection. This
@@ -285,10 +408,16 @@ cm_bsp_model_t *Cm_LoadBspModel(const char *name, int64_t *size) {
   Mem_Free(cm_bsp.leaf_brushes);
   Mem_Free(cm_bsp.brushes);
   Mem_Free(cm_bsp.brush_sides);
+  Mem_Free(cm_bsp.brush_planes);
+  Mem_Free(cm_bsp.bvh_nodes);
+  Mem_Free(cm_bsp.bvh_brushes);
+  Mem_Free(cm_bsp.bvh_roots);
   Mem_Free(cm_bsp.models);
   Mem_Free(cm_bsp.entities);
   Mem_Free(cm_bsp.materials);
   Mem_Free(cm_bsp.voxels);
+  Mem_Free(cm_bsp.pvs);
+  Mem_Free(cm_bsp.phs);
 
   memset(&cm_bsp, 0, sizeof(cm_bsp));
   cm_bsp.file = &file;
@@ -337,8 +466,11 @@ cm_bsp_model_t *Cm_LoadBspModel(const char *name, int64_t *size) {
   Cm_LoadBspLeafBrushes(&cm_bsp);
   Cm_LoadBspBrushSides(&cm_bsp);
   Cm_LoadBspBrushes(&cm_bsp);
+  Cm_LoadBspBrushPlanes(&cm_bsp);
   Cm_LoadBspInlineModels(&cm_bsp);
+  Cm_InitBvh(&cm_bsp);
   Cm_LoadBspVoxels(&cm_bsp);
+  Cm_LoadBspVis(&cm_bsp);
 
   Cm_InitBoxHull(&cm_bsp);
 
@@ -396,6 +528,52 @@ int32_t Cm_LeafContents(const int32_t leaf_num) {
   return cm_bsp.leafs[leaf_num].contents;
 }
 
+/**
+ * @brief Returns the visibility cluster for the given leaf number.
+ */
+int32_t Cm_LeafCluster(const int32_t leaf_num) {
+
+  if (leaf_num < 0 || leaf_num >= cm_bsp.num_leafs) {
+    Com_Error(ERROR_DROP, "Bad number: %d\n", leaf_num);
+  }
+
+  return cm_bsp.leafs[leaf_num].cluster;
+}
+
+/**
+ * @brief Returns the number of visibility clusters in the loaded BSP file.
+ */
+int32_t Cm_NumClusters(void) {
+  return cm_bsp.num_clusters;
+}
+
+/**
+ * @return True if the bit for cluster `b` is set in the row for cluster `a` of `sets`.
+ */
+static inline bool Cm_ClusterSet(const byte *sets, const int32_t a, const int32_t b) {
+
+  if (!sets || a < 0 || b < 0) {
+    return true;
+  }
+
+  const byte *row = sets + a * cm_bsp.cluster_bytes;
+  return row[b >> 3] & (1 << (b & 7));
+}
+
+/**
+ * @return True if cluster `b` is potentially visible from cluster `a`.
+ */
+bool Cm_ClusterVisible(const int32_t a, const int32_t b) {
+  return Cm_ClusterSet(cm_bsp.pvs, a, b);
+}
+
+/**
+ * @return True if cluster `b` is potentially hearable from cluster `a`.
+ */
+bool Cm_ClusterHearable(const int32_t a, const int32_t b) {
+  return Cm_ClusterSet(cm_bsp.phs, a, b);
+}
+
 /**
  * @brief Returns a const pointer to the global BSP collision model.
  */
@@ -56,6 +56,28 @@ const cm_entity_t *Cm_Worldspawn(void);
  */
 int32_t Cm_LeafContents(const int32_t leaf_num);
 
+/**
+ * @brief Returns the visibility cluster for the given BSP leaf number, or -1.
+ */
+int32_t Cm_LeafCluster(const int32_t leaf_num);
+
+/**
+ * @brief Returns the number of visibility clusters, or 0 if the BSP has no visibility data.
+ */
+int32_t Cm_NumClusters(void);
+
+/**
+ * @return True if cluster `b` is potentially visible from cluster `a`.
+ * @remarks Invalid clusters, and maps without visibility data, are always considered visible.
+ */
+bool Cm_ClusterVisible(const int32_t a, const int32_t b);
+
+/**
+ * @return True if cluster `b` is potentially hearable from cluster `a`.
+ * @remarks Invalid clusters, and maps without visibility data, are always considered hearable.
+ */
+bool Cm_ClusterHearable(const int32_t a, const int32_t b);
+
 /**
  * @brief Returns a const pointer to the global BSP collision model.
  */
@@ -65,4 +87,6 @@ const cm_bsp_t *Cm_Bsp(void);
 
 extern cm_bsp_t cm_bsp;
 
+int32_t Cm_PackBrushPlanes(cm_bsp_brush_t *brush, float *planes);
+
 #endif
@@ -207,6 +207,11 @@ typedef struct {
    * @brief The single leaf enclosing the box.
    */
   cm_bsp_leaf_t *leaf;
+
+  /**
+   * @brief The packed planes of the box brush.
+   */
+  float packed_planes[CM_BRUSH_PLANES(6) * 4];
 } cm_box_t;
 
 static cm_box_t cm_box;
@@ -252,6 +257,7 @@ void Cm_InitBoxHull(cm_bsp_t *bsp) {
   // leaf
   cm_box.leaf = &bsp->leafs[bsp->num_leafs];
   cm_box.leaf->contents = CONTENTS_MONSTER;
+  cm_box.leaf->cluster = -1;
   cm_box.leaf->first_leaf_brush = bsp->num_leaf_brushes;
   cm_box.leaf->num_leaf_brushes = 1;
 
@@ -295,6 +301,8 @@ void Cm_InitBoxHull(cm_bsp_t *bsp) {
     cm_bsp_brush_side_t *side = &bsp->brush_sides[bsp->num_brush_sides + i];
     side->plane = bsp->planes + (bsp->num_planes + i * 2 + s);
   }
+
+  Cm_PackBrushPlanes(cm_box.brush, cm_box.packed_planes);
 }
 
 /**
@@ -320,6 +328,8 @@ int32_t Cm_SetBoxHull(const box3_t bounds, const int32_t contents) {
 
   cm_box.leaf->contents = cm_box.brush->contents = contents;
 
+  Cm_PackBrushPlanes(cm_box.brush, cm_box.packed_planes);
+
   return cm_box.head_node;
 }
 
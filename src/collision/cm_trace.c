@@ -21,6 +21,14 @@
 
 #include "cm_local.h"
 
+#if defined(__x86_64__) && defined(__SSE2__)
+ #define CM_SIMD_SSE
+ #include <immintrin.h>
+ #if defined(__GNUC__)
+  #define CM_SIMD_AVX2
+ #endif
+#endif
+
 /**
  * @brief Box trace data encapsulation and context management.
  */
@@ -112,6 +120,214 @@ static inline bool Cm_BrushAlreadyTested(cm_trace_data_t *data, int32_t brush_nu
   return skip;
 }
 
+#if defined(CM_SIMD_SSE)
+
+/**
+ * @brief Selects `a` where `mask` is set, and `b` elsewhere.
+ */
+static inline __m128 Cm_Select_SSE(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/**
+ * @brief Evaluates four brush sides per iteration. See `Cm_BrushSideDistances_`.
+ */
+static void Cm_BrushSideDistances_SSE(const float *planes, int32_t len,
+                                      const vec3_t start, const vec3_t end,
+                                      const vec3_t mins, const vec3_t maxs,
+                                      const mat4_t *matrix, float *d1, float *d2) {
+
+  const __m128 zero = _mm_setzero_ps();
+
+  for (int32_t i = 0; i < len; i += 4) {
+
+    __m128 nx = _mm_loadu_ps(planes + len * 0 + i);
+    __m128 ny = _mm_loadu_ps(planes + len * 1 + i);
+    __m128 nz = _mm_loadu_ps(planes + len * 2 + i);
+    __m128 d = _mm_loadu_ps(planes + len * 3 + i);
+
+    if (matrix) { // as Mat4_TransformPlane
+      const float (*m)[4] = matrix->m;
+
+      const float scale = sqrtf(m[0][0] * m[0][0] + m[0][1] * m[0][1] + m[0][2] * m[0][2]);
+      const __m128 iscale = _mm_set1_ps(1.f / scale);
+
+      const __m128 x = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+                         _mm_mul_ps(nx, _mm_set1_ps(m[0][0])),
+                         _mm_mul_ps(ny, _mm_set1_ps(m[1][0]))),
+                         _mm_mul_ps(nz, _mm_set1_ps(m[2][0]))), iscale);
+      const __m128 y = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+                         _mm_mul_ps(nx, _mm_set1_ps(m[0][1])),
+                         _mm_mul_ps(ny, _mm_set1_ps(m[1][1]))),
+                         _mm_mul_ps(nz, _mm_set1_ps(m[2][1]))), iscale);
+      const __m128 z = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+                         _mm_mul_ps(nx, _mm_set1_ps(m[0][2])),
+                         _mm_mul_ps(ny, _mm_set1_ps(m[1][2]))),
+                         _mm_mul_ps(nz, _mm_set1_ps(m[2][2]))), iscale);
+
+      d = _mm_add_ps(_mm_mul_ps(d, _mm_set1_ps(scale)), _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(x, _mm_set1_ps(m[3][0])),
+            _mm_mul_ps(y, _mm_set1_ps(m[3][1]))),
+            _mm_mul_ps(z, _mm_set1_ps(m[3][2]))));
+
+      nx = x;
+      ny = y;
+      nz = z;
+    }
+
+    // the box corner selected by the plane's sign bits
+    const __m128 ox = Cm_Select_SSE(_mm_cmplt_ps(nx, zero), _mm_set1_ps(maxs.x), _mm_set1_ps(mins.x));
+    const __m128 oy = Cm_Select_SSE(_mm_cmplt_ps(ny, zero), _mm_set1_ps(maxs.y), _mm_set1_ps(mins.y));
+    const __m128 oz = Cm_Select_SSE(_mm_cmplt_ps(nz, zero), _mm_set1_ps(maxs.z), _mm_set1_ps(mins.z));
+
+    const __m128 dist = _mm_sub_ps(d, _mm_add_ps(_mm_add_ps(
+                          _mm_mul_ps(ox, nx),
+                          _mm_mul_ps(oy, ny)),
+                          _mm_mul_ps(oz, nz)));
+
+    _mm_storeu_ps(d1 + i, _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                            _mm_mul_ps(_mm_set1_ps(start.x), nx),
+                            _mm_mul_ps(_mm_set1_ps(start.y), ny)),
+                            _mm_mul_ps(_mm_set1_ps(start.z), nz)), dist));
+
+    _mm_storeu_ps(d2 + i, _mm_sub_ps(_mm_add_ps(_mm_add_ps(
+                            _mm_mul_ps(_mm_set1_ps(end.x), nx),
+                            _mm_mul_ps(_mm_set1_ps(end.y), ny)),
+                            _mm_mul_ps(_mm_set1_ps(end.z), nz)), dist));
+  }
+}
+
+#endif
+
+#if defined(CM_SIMD_AVX2)
+
+/**
+ * @brief Evaluates eight brush sides per iteration. See `Cm_BrushSideDistances_`.
+ * @remarks FMA is deliberately not enabled, so that results match the scalar implementation.
+ */
+__attribute__ ((target("avx2")))
+static void Cm_BrushSideDistances_AVX2(const float *planes, int32_t len,
+                                       const vec3_t start, const vec3_t end,
+                                       const vec3_t mins, const vec3_t maxs,
+                                       const mat4_t *matrix, float *d1, float *d2) {
+
+  const __m256 zero = _mm256_setzero_ps();
+
+  for (int32_t i = 0; i < len; i += 8) {
+
+    __m256 nx = _mm256_loadu_ps(planes + len * 0 + i);
+    __m256 ny = _mm256_loadu_ps(planes + len * 1 + i);
+    __m256 nz = _mm256_loadu_ps(planes + len * 2 + i);
+    __m256 d = _mm256_loadu_ps(planes + len * 3 + i);
+
+    if (matrix) { // as Mat4_TransformPlane
+      const float (*m)[4] = matrix->m;
+
+      const float scale = sqrtf(m[0][0] * m[0][0] + m[0][1] * m[0][1] + m[0][2] * m[0][2]);
+      const __m256 iscale = _mm256_set1_ps(1.f / scale);
+
+      const __m256 x = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(
+                         _mm256_mul_ps(nx, _mm256_set1_ps(m[0][0])),
+                         _mm256_mul_ps(ny, _mm256_set1_ps(m[1][0]))),
+                         _mm256_mul_ps(nz, _mm256_set1_ps(m[2][0]))), iscale);
+      const __m256 y = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(
+                         _mm256_mul_ps(nx, _mm256_set1_ps(m[0][1])),
+                         _mm256_mul_ps(ny, _mm256_set1_ps(m[1][1]))),
+                         _mm256_mul_ps(nz, _mm256_set1_ps(m[2][1]))), iscale);
+      const __m256 z = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(
+                         _mm256_mul_ps(nx, _mm256_set1_ps(m[0][2])),
+                         _mm256_mul_ps(ny, _mm256_set1_ps(m[1][2]))),
+                         _mm256_mul_ps(nz, _mm256_set1_ps(m[2][2]))), iscale);
+
+      d = _mm256_add_ps(_mm256_mul_ps(d, _mm256_set1_ps(scale)), _mm256_add_ps(_mm256_add_ps(
+            _mm256_mul_ps(x, _mm256_set1_ps(m[3][0])),
+            _mm256_mul_ps(y, _mm256_set1_ps(m[3][1]))),
+            _mm256_mul_ps(z, _mm256_set1_ps(m[3][2]))));
+
+      nx = x;
+      ny = y;
+      nz = z;
+    }
+
+    // the box corner selected by the plane's sign bits
+    const __m256 ox = _mm256_blendv_ps(_mm256_set1_ps(mins.x), _mm256_set1_ps(maxs.x), _mm256_cmp_ps(nx, zero, _CMP_LT_OQ));
+    const __m256 oy = _mm256_blendv_ps(_mm256_set1_ps(mins.y), _mm256_set1_ps(maxs.y), _mm256_cmp_ps(ny, zero, _CMP_LT_OQ));
+    const __m256 oz = _mm256_blendv_ps(_mm256_set1_ps(mins.z), _mm256_set1_ps(maxs.z), _mm256_cmp_ps(nz, zero, _CMP_LT_OQ));
+
+    const __m256 dist = _mm256_sub_ps(d, _mm256_add_ps(_mm256_add_ps(
+                          _mm256_mul_ps(ox, nx),
+                          _mm256_mul_ps(oy, ny)),
+                          _mm256_mul_ps(oz, nz)));
+
+    _mm256_storeu_ps(d1 + i, _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(
+                               _mm256_mul_ps(_mm256_set1_ps(start.x), nx),
+                               _mm256_mul_ps(_mm256_set1_ps(start.y), ny)),
+                               _mm256_mul_ps(_mm256_set1_ps(start.z), nz)), dist));
+
+    _mm256_storeu_ps(d2 + i, _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(
+                               _mm256_mul_ps(_mm256_set1_ps(end.x), nx),
+                               _mm256_mul_ps(_mm256_set1_ps(end.y), ny)),
+                               _mm256_mul_ps(_mm256_set1_ps(end.z), nz)), dist));
+  }
+}
+
+#endif
+
+/**
+ * @brief Evaluates the distances of the trace start and end points to every side of the
+ * brush, with each plane pushed out by the corner of the trace bounds selected by its sign
+ * bits. The results are identical to evaluating each brush side in turn.
+ *
+ * @param matrix The matrix to transform the brush planes by, or `NULL`.
+ *
+ * @return True if the distances were evaluated, false if the brush planes are not packed or
+ * no SIMD kernel is available, in which case the caller must evaluate the sides one at a time.
+ */
+static inline bool Cm_BrushSideDistances_(const cm_bsp_brush_t *brush,
+                                          const vec3_t start, const vec3_t end,
+                                          const vec3_t mins, const vec3_t maxs,
+                                          const mat4_t *matrix, float *d1, float *d2) {
+
+  if (!brush->planes) {
+    return false;
+  }
+
+  const int32_t len = CM_BRUSH_PLANES(brush->num_brush_sides);
+
+#if defined(CM_SIMD_AVX2)
+  if (__builtin_cpu_supports("avx2")) {
+    Cm_BrushSideDistances_AVX2(brush->planes, len, start, end, mins, maxs, matrix, d1, d2);
+    return true;
+  }
+#endif
+
+#if defined(CM_SIMD_SSE)
+  Cm_BrushSideDistances_SSE(brush->planes, len, start, end, mins, maxs, matrix, d1, d2);
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Evaluates the distances of the trace start and end points to every side of the
+ * brush several sides at a time, for tools that implement their own brush clipping.
+ *
+ * @param brush The brush.
+ * @param start The trace start point.
+ * @param end The trace end point.
+ * @param bounds The trace bounds, by which each plane is pushed out.
+ * @param d1 The start distances, which must accommodate `CM_BRUSH_PLANES(num_brush_sides)`.
+ * @param d2 The end distances, which must accommodate `CM_BRUSH_PLANES(num_brush_sides)`.
+ *
+ * @return True if the distances were evaluated, false if the caller must evaluate the brush
+ * sides one at a time.
+ */
+bool Cm_BrushSideDistances(const cm_bsp_brush_t *brush, const vec3_t start, const vec3_t end,
+                           const box3_t bounds, float *d1, float *d2) {
+  return Cm_BrushSideDistances_(brush, start, end, bounds.mins, bounds.maxs, NULL, d1, d2);
+}
+
 /**
  * @brief Clips the bounded box to all brush sides for the given brush.
  *
@@ -140,26 +356,39 @@ static void Cm_TraceToBrush_(cm_trace_data_t *data, const cm_bsp_brush_t *brush)
   float leave_fraction = 1.f;
   float nudged_enter_fraction = -1.f;
 
-  cm_bsp_plane_t plane = { };
   const cm_bsp_brush_side_t *side = NULL;
 
   bool start_outside = false, end_outside = false;
 
+  float d1s[CM_BRUSH_PLANES(brush->num_brush_sides)], d2s[CM_BRUSH_PLANES(brush->num_brush_sides)];
+
+  const bool packed = Cm_BrushSideDistances_(brush, data->start, data->end,
+                                             data->offsets[0], data->offsets[7],
+                                             data->is_transformed ? &data->matrix : NULL,
+                                             d1s, d2s);
+
   const cm_bsp_brush_side_t *s = brush->brush_sides + brush->num_brush_sides - 1;
   for (int32_t i = brush->num_brush_sides - 1; i >= 0; i--, s--) {
 
-    cm_bsp_plane_t p;
+    float d1, d2;
 
-    if (data->is_transformed) {
-      p = Cm_TransformPlane(data->matrix, *s->plane);
+    if (packed) {
+      d1 = d1s[i];
+      d2 = d2s[i];
     } else {
-      p = *s->plane;
-    }
+      cm_bsp_plane_t p;
 
-    const float dist = p.dist - Vec3_Dot(data->offsets[p.sign_bits], p.normal);
+      if (data->is_transformed) {
+        p = Cm_TransformPlane(data->matrix, *s->plane);
+      } else {
+        p = *s->plane;
+      }
+
+      const float dist = p.dist - Vec3_Dot(data->offsets[p.sign_bits], p.normal);
 
-    const float d1 = Vec3_Dot(data->start, p.normal) - dist;
-    const float d2 = Vec3_Dot(data->end, p.normal) - dist;
+      d1 = Vec3_Dot(data->start, p.normal) - dist;
+      d2 = Vec3_Dot(data->end, p.normal) - dist;
+    }
 
     if (d1 > 0.f) {
       start_outside = true;
@@ -185,7 +414,6 @@ static void Cm_TraceToBrush_(cm_trace_data_t *data, const cm_bsp_brush_t *brush)
       const float f = d1 / d2d1_dist;
       if (f > enter_fraction) {
         enter_fraction = f;
-        plane = p;
         side = s;
         nudged_enter_fraction = (d1 - TRACE_EPSILON) / d2d1_dist;
       }
@@ -214,7 +442,7 @@ static void Cm_TraceToBrush_(cm_trace_data_t *data, const cm_bsp_brush_t *brush)
       data->trace.fraction = nudged_enter_fraction;
       data->trace.brush = brush;
       data->trace.brush_side = side;
-      data->trace.plane = plane;
+      data->trace.plane = data->is_transformed ? Cm_TransformPlane(data->matrix, *side->plane) : *side->plane;
       data->trace.contents = side->contents;
       data->trace.surface = side->surface;
       data->trace.material = side->material;
@@ -444,6 +672,194 @@ next:;
   }
 }
 
+/**
+ * @brief The trace backend.
+ */
+static cm_trace_backend_t cm_trace_backend;
+
+/**
+ * @brief Selects the trace backend. Inline models without a brush bounding volume
+ * hierarchy, as well as the box hull, are always traced through the BSP tree.
+ */
+void Cm_SetTraceBackend(cm_trace_backend_t backend) {
+  cm_trace_backend = backend;
+}
+
+/**
+ * @return The brush bounding volume hierarchy root for the given head node, or -1 if the
+ * trace should descend the BSP tree.
+ */
+static inline int32_t Cm_BvhRoot(int32_t head_node) {
+
+  if (cm_trace_backend != CM_TRACE_BVH || !cm_bsp.bvh_roots) {
+    return -1;
+  }
+
+  if (head_node < 0 || head_node >= cm_bsp.num_nodes) {
+    return -1;
+  }
+
+  return cm_bsp.bvh_roots[head_node];
+}
+
+/**
+ * @brief Clips the segment from `p1` to `p2` to the node bounds, expanded by the trace size.
+ * @return True if the swept box may intersect the brushes beneath the node, with `enter`
+ * set to the fraction at which it enters the node.
+ */
+static inline bool Cm_TraceToBvhNode(const cm_trace_data_t *data, const cm_bvh_node_t *node,
+                                     const vec3_t p1, const vec3_t dir, float *enter) {
+
+  float t1 = 0.f, t2 = data->unnudged_fraction;
+
+  for (int32_t i = 0; i < 3; i++) {
+
+    const float mins = node->bounds.mins.xyz[i] - data->size.xyz[i];
+    const float maxs = node->bounds.maxs.xyz[i] + data->size.xyz[i];
+
+    if (dir.xyz[i] == 0.f) {
+      if (p1.xyz[i] < mins || p1.xyz[i] > maxs) {
+        return false;
+      }
+      continue;
+    }
+
+    const float scale = 1.f / dir.xyz[i];
+
+    float near = (mins - p1.xyz[i]) * scale;
+    float far = (maxs - p1.xyz[i]) * scale;
+
+    if (near > far) {
+      const float f = near;
+      near = far;
+      far = f;
+    }
+
+    t1 = Maxf(t1, near);
+    t2 = Minf(t2, far);
+
+    if (t1 > t2) {
+      return false;
+    }
+  }
+
+  *enter = t1;
+  return true;
+}
+
+/**
+ * @brief Clips the trace against the brushes of the bounding volume hierarchy at `root`.
+ * Nodes are visited nearest first, so that nodes beyond the nearest impact are culled.
+ */
+static void Cm_TraceToBvh(cm_trace_data_t *data, int32_t root, const vec3_t p1, const vec3_t p2) {
+
+  const vec3_t dir = Vec3_Subtract(p2, p1);
+
+  struct {
+    int32_t num;
+    float enter;
+  } stack[CM_BVH_MAX_DEPTH + 1];
+
+  int32_t depth = 0;
+
+  float enter;
+  if (!Cm_TraceToBvhNode(data, &cm_bsp.bvh_nodes[root], p1, dir, &enter)) {
+    return;
+  }
+
+  stack[depth].num = root;
+  stack[depth++].enter = enter;
+
+  while (depth) {
+    depth--;
+
+    if (stack[depth].enter >= data->unnudged_fraction) {
+      continue;
+    }
+
+    const int32_t num = stack[depth].num;
+    const cm_bvh_node_t *node = &cm_bsp.bvh_nodes[num];
+
+    if (node->count) {
+      for (int32_t i = 0; i < node->count; i++) {
+        const cm_bsp_brush_t *b = &cm_bsp.brushes[cm_bsp.bvh_brushes[node->first + i]];
+
+        if (!(b->contents & data->contents)) {
+          continue;
+        }
+
+        Cm_TraceToBrush_(data, b);
+
+        if (data->trace.all_solid) {
+          return;
+        }
+      }
+      continue;
+    }
+
+    const int32_t children[2] = { num + 1, node->first };
+    float enters[2];
+
+    const bool hits[2] = {
+      Cm_TraceToBvhNode(data, &cm_bsp.bvh_nodes[children[0]], p1, dir, &enters[0]),
+      Cm_TraceToBvhNode(data, &cm_bsp.bvh_nodes[children[1]], p1, dir, &enters[1])
+    };
+
+    // push the farther child first, so that the nearer child is visited first
+    const int32_t near = (hits[0] && hits[1]) ? enters[1] < enters[0] : !hits[0];
+
+    if (hits[near ^ 1]) {
+      stack[depth].num = children[near ^ 1];
+      stack[depth++].enter = enters[near ^ 1];
+    }
+
+    if (hits[near]) {
+      stack[depth].num = children[near];
+      stack[depth++].enter = enters[near];
+    }
+  }
+}
+
+/**
+ * @brief Tests the trace start position against the brushes of the bounding volume
+ * hierarchy at `root` that intersect the trace bounds.
+ */
+static void Cm_TestInBvh(cm_trace_data_t *data, int32_t root) {
+
+  int32_t stack[CM_BVH_MAX_DEPTH + 1];
+  int32_t depth = 0;
+
+  stack[depth++] = root;
+
+  while (depth) {
+    const int32_t num = stack[--depth];
+    const cm_bvh_node_t *node = &cm_bsp.bvh_nodes[num];
+
+    if (!Box3_Intersects(data->model_abs_bounds, node->bounds)) {
+      continue;
+    }
+
+    if (node->count) {
+      for (int32_t i = 0; i < node->count; i++) {
+        const cm_bsp_brush_t *b = &cm_bsp.brushes[cm_bsp.bvh_brushes[node->first + i]];
+
+        if (!(b->contents & data->contents)) {
+          continue;
+        }
+
+        Cm_TestBoxInBrush(data, b);
+
+        if (data->trace.all_solid) {
+          return;
+        }
+      }
+      continue;
+    }
+
+    stack[depth++] = node->first;
+    stack[depth++] = num + 1;
+  }
+}
 
 /**
  * @brief Primary collision detection entry point. This function recurses down
@@ -475,8 +891,18 @@ static inline cm_trace_t Cm_BoxTrace_(cm_trace_data_t *data) {
     ? Mat4_TransformBounds(data->inverse_matrix, data->abs_bounds)
     : data->abs_bounds;
 
+  const int32_t bvh_root = Cm_BvhRoot(data->head_node);
+
   // check for position test special case
   if (Vec3_Equal(data->start, data->end)) {
+
+    if (bvh_root != -1) {
+      Cm_TestInBvh(data, bvh_root);
+
+      data->trace.end = data->start;
+      return data->trace;
+    }
+
     static __thread int32_t leafs[MAX_BSP_LEAFS];
 
     const size_t num_leafs = Cm_BoxLeafnums(data->model_abs_bounds,
@@ -497,12 +923,20 @@ static inline cm_trace_t Cm_BoxTrace_(cm_trace_data_t *data) {
     return data->trace;
   }
 
+  vec3_t p1 = data->start, p2 = data->end;
+
   if (data->is_transformed) {
     data->size = Box3_Symetrical(Mat4_TransformBounds(data->inverse_matrix, Box3_Expand(data->bounds, BOX_EPSILON)));
-    Cm_TraceToNode(data, data->head_node, 0.f, 1.f, Mat4_Transform(data->inverse_matrix, data->start), Mat4_Transform(data->inverse_matrix, data->end));
+    p1 = Mat4_Transform(data->inverse_matrix, p1);
+    p2 = Mat4_Transform(data->inverse_matrix, p2);
   } else {
     data->size = Box3_Symetrical(Box3_Expand(data->bounds, BOX_EPSILON));
-    Cm_TraceToNode(data, data->head_node, 0.f, 1.f, data->start, data->end);
+  }
+
+  if (bvh_root != -1) {
+    Cm_TraceToBvh(data, bvh_root, p1, p2);
+  } else {
+    Cm_TraceToNode(data, data->head_node, 0.f, 1.f, p1, p2);
   }
 
   data->trace.fraction = Maxf(0.f, data->trace.fraction);
@@ -587,6 +1021,238 @@ cm_trace_t Cm_BoxTrace(const vec3_t start, const vec3_t end, const box3_t bounds
   });
 }
 
+/**
+ * @brief The minimum number of traces per thread when a trace batch is dispatched to the
+ * thread pool. Smaller batches are traced on the calling thread.
+ */
+#define CM_TRACE_BATCH_SLICE 32
+
+/**
+ * @brief A contiguous slice of a trace batch, traced by a single thread.
+ */
+typedef struct {
+  /**
+   * @brief The trace data shared by every trace in the slice: bounds, size, offsets,
+   * contents and matrices, as well as the head node resolved for the whole batch.
+   */
+  cm_trace_data_t data;
+
+  /**
+   * @brief The trace start and end points, as provided by the user.
+   */
+  const vec3_t *start, *end;
+
+  /**
+   * @brief The trace results.
+   */
+  cm_trace_t *traces;
+
+  /**
+   * @brief The number of traces in the slice.
+   */
+  size_t count;
+} cm_trace_batch_t;
+
+/**
+ * @brief Descends the BSP tree from the batch head node for as long as every trace in the
+ * batch would select the same child, applying the same sidedness test as `Cm_TraceToNode`.
+ * The returned node is thus an equivalent head node for every trace in the batch.
+ */
+static int32_t Cm_TraceBatchHeadNode(const cm_trace_batch_t *batch) {
+
+  int32_t num = batch->data.head_node;
+  const vec3_t size = batch->data.size;
+
+  while (true) {
+    const cm_bsp_node_t *node = cm_bsp.nodes + num;
+    const cm_bsp_plane_t *plane = node->plane;
+
+    const float offset = AXIAL(plane)
+      ? size.xyz[plane->type]
+      : fabsf(size.x * plane->normal.x) + fabsf(size.y * plane->normal.y) + fabsf(size.z * plane->normal.z);
+
+    int32_t side = -1;
+    for (size_t i = 0; i < batch->count; i++) {
+
+      vec3_t p1 = batch->start[i], p2 = batch->end[i];
+      if (batch->data.is_transformed) {
+        p1 = Mat4_Transform(batch->data.inverse_matrix, p1);
+        p2 = Mat4_Transform(batch->data.inverse_matrix, p2);
+      }
+
+      float d1, d2;
+      if (AXIAL(plane)) {
+        d1 = p1.xyz[plane->type] - plane->dist;
+        d2 = p2.xyz[plane->type] - plane->dist;
+      } else {
+        d1 = Vec3_Dot(plane->normal, p1) - plane->dist;
+        d2 = Vec3_Dot(plane->normal, p2) - plane->dist;
+      }
+
+      int32_t s;
+      if (d1 >= offset && d2 >= offset) {
+        s = 0;
+      } else if (d1 < -offset && d2 < -offset) {
+        s = 1;
+      } else {
+        return num;
+      }
+
+      if (side == -1) {
+        side = s;
+      } else if (side != s) {
+        return num;
+      }
+    }
+
+    if (side == -1 || node->children[side] < 0) {
+      return num;
+    }
+
+    num = node->children[side];
+  }
+}
+
+/**
+ * @brief Traces a slice of a trace batch. This is the thread pool entry point.
+ */
+static void Cm_TraceBatchSlice(void *data) {
+
+  cm_trace_batch_t *batch = data;
+
+  for (size_t i = 0; i < batch->count; i++) {
+
+    cm_trace_data_t trace = batch->data;
+
+    trace.start = batch->start[i];
+    trace.end = batch->end[i];
+    trace.abs_bounds = Cm_TraceBounds(trace.start, trace.end, trace.bounds);
+
+    batch->traces[i] = Cm_BoxTrace_(&trace);
+  }
+}
+
+/**
+ * @brief Traces a batch of boxes sharing the same bounds, head node, contents and
+ * transform. The BSP descent common to every trace is performed once, and large batches
+ * are divided across the thread pool.
+ */
+static void Cm_TraceBatch_(cm_trace_batch_t *batch) {
+
+  if (!cm_bsp.num_nodes) { // map not loaded
+    for (size_t i = 0; i < batch->count; i++) {
+      batch->traces[i] = batch->data.trace;
+    }
+    return;
+  }
+
+  if (batch->data.is_transformed) {
+    batch->data.size = Box3_Symetrical(Mat4_TransformBounds(batch->data.inverse_matrix, Box3_Expand(batch->data.bounds, BOX_EPSILON)));
+  } else {
+    batch->data.size = Box3_Symetrical(Box3_Expand(batch->data.bounds, BOX_EPSILON));
+  }
+
+  // the brush bounding volume hierarchy is rooted at the model's head node
+  if (Cm_BvhRoot(batch->data.head_node) == -1) {
+    batch->data.head_node = Cm_TraceBatchHeadNode(batch);
+  }
+
+  const size_t num_slices = Mini(Thread_Count() + 1, (int32_t) (batch->count / CM_TRACE_BATCH_SLICE));
+  if (num_slices < 2) {
+    Cm_TraceBatchSlice(batch);
+    return;
+  }
+
+  cm_trace_batch_t slices[num_slices];
+  thread_t *threads[num_slices];
+
+  const size_t slice_count = (batch->count + num_slices - 1) / num_slices;
+
+  for (size_t i = 0, offset = 0; i < num_slices; i++, offset += slice_count) {
+
+    slices[i] = *batch;
+    slices[i].start += offset;
+    slices[i].end += offset;
+    slices[i].traces += offset;
+    slices[i].count = Mini(slice_count, batch->count - offset);
+
+    if (i < num_slices - 1) {
+      threads[i] = Thread_Create(Cm_TraceBatchSlice, &slices[i], THREAD_NONE);
+    } else {
+      Cm_TraceBatchSlice(&slices[i]);
+    }
+  }
+
+  for (size_t i = 0; i < num_slices - 1; i++) {
+    Thread_Wait(threads[i]);
+  }
+}
+
+/**
+ * @brief Traces a batch of boxes from `start[i]` to `end[i]`, all sharing the same bounds,
+ * head node and contents mask. The results are identical to `count` calls to `Cm_BoxTrace`,
+ * but the BSP descent common to the entire batch is performed only once, and large batches
+ * are divided across the thread pool.
+ *
+ * @param start The trace start points.
+ * @param end The trace end points.
+ * @param count The number of traces.
+ * @param bounds The bounding box, in model space.
+ * @param head_node The BSP head node to recurse down.
+ * @param contents The contents mask to clip to.
+ * @param traces The trace results, which must accommodate `count` traces.
+ */
+void Cm_BoxTraceBatch(const vec3_t *start, const vec3_t *end, size_t count, const box3_t bounds,
+                      int32_t head_node, int32_t contents, cm_trace_t *traces) {
+
+  Cm_TraceBatch_(&(cm_trace_batch_t) {
+    .data = {
+      .bounds = bounds,
+      .head_node = head_node,
+      .contents = contents,
+      .is_transformed = false,
+      .trace = (cm_trace_t) {
+        .fraction = 1.f
+      },
+      .unnudged_fraction = 1.f + TRACE_EPSILON
+    },
+    .start = start,
+    .end = end,
+    .traces = traces,
+    .count = count
+  });
+}
+
+/**
+ * @brief Like `Cm_BoxTraceBatch`, but applies a model transform to the start, end and planes.
+ *
+ * @param matrix The matrix to adjust tested planes by.
+ * @param inverse_matrix The inverse matrix to adjust the inputs by.
+ */
+void Cm_TransformedBoxTraceBatch(const vec3_t *start, const vec3_t *end, size_t count, const box3_t bounds,
+                                 int32_t head_node, int32_t contents, const mat4_t matrix,
+                                 const mat4_t inverse_matrix, cm_trace_t *traces) {
+
+  Cm_TraceBatch_(&(cm_trace_batch_t) {
+    .data = {
+      .bounds = bounds,
+      .head_node = head_node,
+      .matrix = matrix,
+      .inverse_matrix = inverse_matrix,
+      .contents = contents,
+      .is_transformed = true,
+      .trace = (cm_trace_t) {
+        .fraction = 1.f
+      },
+      .unnudged_fraction = 1.f + TRACE_EPSILON
+    },
+    .start = start,
+    .end = end,
+    .traces = traces,
+    .count = count
+  });
+}
+
 /**
  * @brief Traces a point ray from `start` to `end` against a single brush.
  * @param start The trace start point.
@@ -35,6 +35,25 @@ __attribute__ ((warn_unused_result))
 cm_trace_t Cm_BoxTrace(const vec3_t start, const vec3_t end, const box3_t bounds, int32_t head_node,
              int32_t contents);
 
+/** @brief Traces a batch of boxes sharing bounds, head node and contents, as if by `count`
+ *   calls to Cm_BoxTrace. The BSP descent common to the batch is performed once, and large
+ *   batches are divided across the thread pool.
+ * @param start The trace start points.
+ * @param end The trace end points.
+ * @param count The number of traces.
+ * @param traces The trace results, which must accommodate `count` traces.
+ */
+void Cm_BoxTraceBatch(const vec3_t *start, const vec3_t *end, size_t count, const box3_t bounds,
+                      int32_t head_node, int32_t contents, cm_trace_t *traces);
+
+/** @brief Like Cm_BoxTraceBatch but applies a model transform to start, end and planes.
+ * @param matrix The forward transform of the entity being traced against.
+ * @param inverse_matrix The inverse transform, used to bring the rays into model space.
+ */
+void Cm_TransformedBoxTraceBatch(const vec3_t *start, const vec3_t *end, size_t count, const box3_t bounds,
+                                 int32_t head_node, int32_t contents, const mat4_t matrix,
+                                 const mat4_t inverse_matrix, cm_trace_t *traces);
+
 /** @brief Traces a point ray from `start` to `end` against a single brush.
  * @param start The trace start point.
  * @param end The trace end point.
@@ -45,6 +64,16 @@ cm_trace_t Cm_BoxTrace(const vec3_t start, const vec3_t end, const box3_t bounds
 __attribute__ ((warn_unused_result))
 cm_trace_t Cm_TraceToBrush(const vec3_t start, const vec3_t end, const cm_bsp_brush_t *brush);
 
+/** @brief Evaluates the distances of the trace endpoints to every side of the brush, several
+ *   sides at a time, with each plane pushed out by the trace bounds.
+ * @param d1 The start distances, which must accommodate `CM_BRUSH_PLANES(num_brush_sides)`.
+ * @param d2 The end distances, which must accommodate `CM_BRUSH_PLANES(num_brush_sides)`.
+ * @return True if the distances were evaluated, false if the caller must evaluate the brush
+ *   sides one at a time (the brush planes are not packed, or SIMD is unavailable).
+ */
+bool Cm_BrushSideDistances(const cm_bsp_brush_t *brush, const vec3_t start, const vec3_t end,
+                           const box3_t bounds, float *d1, float *d2);
+
 /** @brief Like Cm_BoxTrace but applies a model transform to start, end and planes.
  * @param matrix The forward transform of the entity being traced against.
  * @param inverse_matrix The inverse transform, used to bring the ray into model space.
@@ -67,5 +96,11 @@ box3_t Cm_EntityBounds(const solid_t solid, const mat4_t matrix, const box3_t bo
 __attribute__ ((warn_unused_result))
 box3_t Cm_TraceBounds(const vec3_t start, const vec3_t end, const box3_t bounds);
 
+/** @brief Selects the trace backend for inline models: the BSP tree, or the brush bounding
+ *   volume hierarchy. Both produce equivalent results. This must not be called while
+ *   traces are in progress on other threads.
+ */
+void Cm_SetTraceBackend(cm_trace_backend_t backend);
+
 #if defined(__CM_LOCAL_H__)
 #endif
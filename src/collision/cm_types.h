@@ -56,6 +56,11 @@
  */
 #define TRACE_EPSILON      .125f
 
+/**
+ * @brief The maximum number of traces in a single trace batch.
+ */
+#define MAX_TRACE_BATCH    256
+
 /**
  * @brief Plane side constants used for BSP recursion.
  */
@@ -268,6 +273,17 @@ typedef struct cm_bsp_brush_side_s {
   int32_t value;
 } cm_bsp_brush_side_t;
 
+/**
+ * @brief The number of brush sides evaluated per SIMD iteration. Packed brush planes are
+ * padded to a multiple of this width.
+ */
+#define CM_BRUSH_PLANES_WIDTH 8
+
+/**
+ * @brief The padded length of each array of packed brush planes for `n` brush sides.
+ */
+#define CM_BRUSH_PLANES(n) (((n) + CM_BRUSH_PLANES_WIDTH - 1) & ~(CM_BRUSH_PLANES_WIDTH - 1))
+
 /**
  * @brief Brushes are convex volumes defined by the clipping planes of their sides.
  */
@@ -299,6 +315,14 @@ typedef struct cm_bsp_brush_s {
    * @brief The brush bounds.
    */
   box3_t bounds;
+
+  /**
+   * @brief The brush side planes in structure-of-arrays layout, for SIMD evaluation: the
+   * normal x, y and z components, followed by the distances, each padded to
+   * `CM_BRUSH_PLANES(num_brush_sides)` floats. This may be `NULL` for brushes that were
+   * not loaded from a BSP, in which case the brush sides are evaluated one at a time.
+   */
+  float *planes;
 } cm_bsp_brush_t;
 
 /**
@@ -314,6 +338,11 @@ typedef struct {
    */
   int32_t contents;
 
+  /**
+   * @brief The visibility cluster of this leaf, or -1.
+   */
+  int32_t cluster;
+
   /**
    * @brief The index of the first leaf-brush reference.
    */
@@ -342,6 +371,44 @@ typedef struct {
   int32_t children[2];
 } cm_bsp_node_t;
 
+/**
+ * @brief Bounding volume hierarchy nodes partition the brushes of an inline model by
+ * their bounds. They offer an alternative to the BSP tree for traces.
+ */
+typedef struct {
+
+  /**
+   * @brief The bounds of all brushes beneath this node.
+   */
+  box3_t bounds;
+
+  /**
+   * @brief For leaf nodes, the index of the first brush reference. For interior nodes,
+   * the index of the second child; the first child immediately follows its parent.
+   */
+  int32_t first;
+
+  /**
+   * @brief The number of brush references for leaf nodes, or 0 for interior nodes.
+   */
+  int32_t count;
+} cm_bvh_node_t;
+
+/**
+ * @brief The trace backends.
+ */
+typedef enum {
+  /**
+   * @brief Traces descend the BSP tree, testing the brushes of each leaf they pass through.
+   */
+  CM_TRACE_BSP,
+
+  /**
+   * @brief Traces descend the brush bounding volume hierarchy of the inline model.
+   */
+  CM_TRACE_BVH,
+} cm_trace_backend_t;
+
 /**
  * @brief Per-voxel data decoded from the BSP voxel lump.
  */
@@ -445,6 +512,16 @@ typedef struct {
    */
   cm_bsp_brush_side_t *brush_sides;
 
+  /**
+   * @brief Number of packed brush plane floats.
+   */
+  int32_t num_brush_planes;
+
+  /**
+   * @brief Packed brush plane array, referenced by each brush's `planes`.
+   */
+  float *brush_planes;
+
   /**
    * @brief Number of leaf-brush references.
    */
@@ -455,6 +532,32 @@ typedef struct {
    */
   int32_t *leaf_brushes;
 
+  /**
+   * @brief Number of brush bounding volume hierarchy nodes.
+   */
+  int32_t num_bvh_nodes;
+
+  /**
+   * @brief Brush bounding volume hierarchy node array, containing one tree per inline model.
+   */
+  cm_bvh_node_t *bvh_nodes;
+
+  /**
+   * @brief Number of brush bounding volume hierarchy brush references.
+   */
+  int32_t num_bvh_brushes;
+
+  /**
+   * @brief Brush bounding volume hierarchy brush reference array.
+   */
+  int32_t *bvh_brushes;
+
+  /**
+   * @brief The brush bounding volume hierarchy root for each BSP node, or -1 if the node
+   * is not the head node of an inline model. Indexed by node number.
+   */
+  int32_t *bvh_roots;
+
   /**
    * @brief Number of inline models.
    */
@@ -505,6 +608,26 @@ typedef struct {
    */
   cm_voxel_t *voxels;
 
+  /**
+   * @brief Number of visibility clusters, or 0 if the map was compiled without visibility.
+   */
+  int32_t num_clusters;
+
+  /**
+   * @brief The size in bytes of each decompressed cluster bit vector.
+   */
+  int32_t cluster_bytes;
+
+  /**
+   * @brief Decompressed potentially visible sets, `cluster_bytes` per cluster.
+   */
+  byte *pvs;
+
+  /**
+   * @brief Decompressed potentially hearable sets, `cluster_bytes` per cluster.
+   */
+  byte *phs;
+
 } cm_bsp_t;
 
 /**
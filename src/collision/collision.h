@@ -24,6 +24,7 @@
 #include "common/common.h"
 
 #include "cm_bsp.h"
+#include "cm_bvh.h"
 #include "cm_entity.h"
 #include "cm_manifest.h"
 #include "cm_material.h"
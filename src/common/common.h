@@ -29,6 +29,7 @@
 #include "cmd.h"
 #include "console.h"
 #include "cvar.h"
+#include "demo.h"
 #include "filesystem.h"
 #include "image.h"
 #include "installer.h"
@@ -48,7 +49,7 @@
  * of core net messages or serialized data types change. The game and client
  * game maintain `PROTOCOL_MINOR` as well.
  */
-#define PROTOCOL_MAJOR 2029
+#define PROTOCOL_MAJOR 2031
 
 /**
  * @brief The IP address of the master server, where the authoritative list of
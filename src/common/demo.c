@@ -0,0 +1,716 @@
+/*
+ * Copyright(c) 1997-2001 id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quetoo.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <zlib.h>
+
+#include "demo.h"
+
+/**
+ * @brief Allocates the block buffers of the specified demo.
+ */
+static demo_t *Demo_Alloc(file_t *file, bool writing, bool compressed) {
+
+  demo_t *demo = Mem_Malloc(sizeof(demo_t));
+
+  demo->file = file;
+  demo->writing = writing;
+  demo->compressed = compressed;
+
+  demo->block = Mem_Link(Mem_Malloc(DEMO_BLOCK_SIZE), demo);
+
+  if (compressed) {
+    demo->compressed_block = Mem_Link(Mem_Malloc(compressBound(DEMO_BLOCK_SIZE)), demo);
+  }
+
+  return demo;
+}
+
+/**
+ * @brief Opens the specified demo file for writing.
+ * @param compressed True to write the compressed container, false to write the legacy format.
+ */
+demo_t *Demo_OpenWrite(const char *filename, bool compressed) {
+
+  file_t *file = Fs_OpenWrite(filename);
+  if (!file) {
+    return NULL;
+  }
+
+  demo_t *demo = Demo_Alloc(file, true, compressed);
+
+  if (compressed) {
+    const demo_header_t header = {
+      .ident = LittleLong(DEMO_ID),
+      .version = LittleLong(DEMO_VERSION)
+    };
+
+    Fs_Write(file, &header, sizeof(header), 1);
+  }
+
+  return demo;
+}
+
+/**
+ * @brief Compresses and writes the current block.
+ */
+static void Demo_WriteBlock(demo_t *demo) {
+
+  z_stream stream = {
+    .next_in = demo->block,
+    .avail_in = (uInt) demo->block_offset,
+    .next_out = demo->compressed_block,
+    .avail_out = (uInt) compressBound(DEMO_BLOCK_SIZE)
+  };
+
+  if (deflateInit(&stream, Z_BEST_COMPRESSION) != Z_OK) {
+    Com_Warn("Failed to initialize compression: %s\n", stream.msg ?: "");
+    return;
+  }
+
+  if (demo->dictionary) {
+    deflateSetDictionary(&stream, demo->dictionary, (uInt) demo->dictionary_size);
+  }
+
+  const int32_t err = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+
+  if (err != Z_STREAM_END) {
+    Com_Warn("Failed to compress demo block: %d\n", err);
+    return;
+  }
+
+  const demo_block_t header = {
+    .compressed_size = LittleLong((int32_t) stream.total_out),
+    .size = LittleLong((int32_t) demo->block_offset),
+    .first_message = LittleLong(demo->block_header.first_message),
+    .num_messages = LittleLong(demo->block_header.num_messages),
+    .time = LittleLong(demo->block_header.time),
+    .keyframe = LittleLong(demo->block_header.keyframe)
+  };
+
+  Fs_Write(demo->file, &header, sizeof(header), 1);
+  Fs_Write(demo->file, demo->compressed_block, stream.total_out, 1);
+
+  // the first block becomes the dictionary for all that follow
+  if (!demo->dictionary) {
+    demo->dictionary = Mem_Link(Mem_Malloc(demo->block_offset), demo);
+    demo->dictionary_size = demo->block_offset;
+
+    memcpy(demo->dictionary, demo->block, demo->block_offset);
+  }
+}
+
+/**
+ * @brief Writes the specified message to the demo.
+ * @param time The caller's current time, in milliseconds. Timecodes are relative to the
+ * time of the first message written.
+ */
+void Demo_WriteMessage(demo_t *demo, const void *data, size_t len, uint32_t time) {
+
+  assert(demo->writing);
+
+  if (len == 0) {
+    return;
+  }
+
+  if (len > DEMO_MAX_MESSAGE_SIZE) {
+    Com_Warn("Demo message of %zu bytes is too large\n", len);
+    return;
+  }
+
+  if (demo->message == 0) {
+    demo->start_time = time;
+  }
+
+  demo->time = time > demo->start_time ? time - demo->start_time : 0;
+
+  const int32_t size = LittleLong((int32_t) len);
+
+  if (!demo->compressed) {
+    Fs_Write(demo->file, &size, sizeof(size), 1);
+    Fs_Write(demo->file, data, len, 1);
+  } else {
+    if (demo->block_offset + sizeof(size) * 2 + len > DEMO_BLOCK_SIZE) {
+      Demo_Flush(demo);
+    }
+
+    if (demo->block_header.num_messages == 0) {
+      demo->block_header.time = demo->time;
+    }
+
+    const int32_t timecode = LittleLong((int32_t) demo->time);
+
+    memcpy(demo->block + demo->block_offset, &size, sizeof(size));
+    demo->block_offset += sizeof(size);
+
+    memcpy(demo->block + demo->block_offset, &timecode, sizeof(timecode));
+    demo->block_offset += sizeof(timecode);
+
+    memcpy(demo->block + demo->block_offset, data, len);
+    demo->block_offset += len;
+
+    demo->block_header.num_messages++;
+  }
+
+  demo->message++;
+}
+
+/**
+ * @brief Writes the specified keyframe, a full non-delta frame, to the demo. Keyframes
+ * begin a new block and are added to the index, so that playback may seek to them.
+ */
+void Demo_WriteKeyframe(demo_t *demo, const void *data, size_t len, uint32_t time) {
+
+  assert(demo->writing);
+
+  if (demo->compressed && len && len <= DEMO_MAX_MESSAGE_SIZE) {
+    Demo_Flush(demo);
+
+    if (demo->message == 0) {
+      demo->start_time = time;
+    }
+
+    demo->keyframes = Mem_Realloc(demo->keyframes, (demo->num_keyframes + 1) * sizeof(demo_keyframe_t));
+    if (demo->num_keyframes == 0) {
+      Mem_Link(demo->keyframes, demo);
+    }
+
+    demo->keyframes[demo->num_keyframes++] = (demo_keyframe_t) {
+      .time = time > demo->start_time ? time - demo->start_time : 0,
+      .message = demo->message,
+      .offset = (int32_t) Fs_Tell(demo->file)
+    };
+
+    demo->block_header.keyframe = 1;
+  }
+
+  Demo_WriteMessage(demo, data, len, time);
+}
+
+/**
+ * @return True if the recorder should request a keyframe at the specified time. A full
+ * frame is always required to begin a demo, and compressed demos periodically require
+ * another, so that they remain seekable.
+ */
+bool Demo_KeyframeDue(const demo_t *demo, uint32_t time) {
+
+  if (demo->message == 0) {
+    return true;
+  }
+
+  if (!demo->compressed) {
+    return false;
+  }
+
+  if (demo->num_keyframes == 0) {
+    return true;
+  }
+
+  const int64_t elapsed = (int64_t) time - demo->start_time - demo->keyframes[demo->num_keyframes - 1].time;
+  return elapsed >= DEMO_KEYFRAME_MILLIS;
+}
+
+/**
+ * @brief Ends the current block, so that the next message begins a new one. Writers
+ * flush once the demo header is written, so that the header alone forms the dictionary.
+ */
+void Demo_Flush(demo_t *demo) {
+
+  assert(demo->writing);
+
+  if (demo->compressed && demo->block_offset) {
+    Demo_WriteBlock(demo);
+
+    demo->block_offset = 0;
+    demo->block_header.first_message = demo->message;
+    demo->block_header.num_messages = 0;
+    demo->block_header.time = 0;
+    demo->block_header.keyframe = 0;
+  }
+}
+
+/**
+ * @brief Reads the next block header.
+ * @return 1 on success, 0 at the end of the demo, or -1 on error.
+ */
+static int32_t Demo_ReadBlockHeader(demo_t *demo) {
+
+  demo_block_t *header = &demo->block_header;
+
+  if (Fs_Read(demo->file, &header->compressed_size, sizeof(int32_t), 1) != 1) {
+    Com_Warn("Failed to read demo block\n");
+    return -1;
+  }
+
+  header->compressed_size = LittleLong(header->compressed_size);
+
+  if (header->compressed_size == -1) {
+    return 0;
+  }
+
+  if (Fs_Read(demo->file, &header->size, sizeof(demo_block_t) - sizeof(int32_t), 1) != 1) {
+    Com_Warn("Failed to read demo block\n");
+    return -1;
+  }
+
+  header->size = LittleLong(header->size);
+  header->first_message = LittleLong(header->first_message);
+  header->num_messages = LittleLong(header->num_messages);
+  header->time = LittleLong(header->time);
+  header->keyframe = LittleLong(header->keyframe);
+
+  if (header->compressed_size < 0 || header->compressed_size > (int32_t) compressBound(DEMO_BLOCK_SIZE) ||
+      header->size < 0 || header->size > DEMO_BLOCK_SIZE) {
+    Com_Warn("Corrupt demo block\n");
+    return -1;
+  }
+
+  return 1;
+}
+
+/**
+ * @brief Reads and decompresses the block whose header was just read.
+ * @return True on success.
+ */
+static bool Demo_ReadBlockData(demo_t *demo) {
+
+  const demo_block_t *header = &demo->block_header;
+
+  if (Fs_Read(demo->file, demo->compressed_block, header->compressed_size, 1) != 1) {
+    Com_Warn("Failed to read demo block\n");
+    return false;
+  }
+
+  z_stream stream = {
+    .next_in = demo->compressed_block,
+    .avail_in = (uInt) header->compressed_size,
+    .next_out = demo->block,
+    .avail_out = DEMO_BLOCK_SIZE
+  };
+
+  if (inflateInit(&stream) != Z_OK) {
+    Com_Warn("Failed to initialize decompression: %s\n", stream.msg ?: "");
+    return false;
+  }
+
+  int32_t err = inflate(&stream, Z_FINISH);
+
+  if (err == Z_NEED_DICT && demo->dictionary) {
+    if (inflateSetDictionary(&stream, demo->dictionary, (uInt) demo->dictionary_size) == Z_OK) {
+      err = inflate(&stream, Z_FINISH);
+    }
+  }
+
+  inflateEnd(&stream);
+
+  if (err != Z_STREAM_END || stream.total_out != (uLong) header->size) {
+    Com_Warn("Failed to decompress demo block: %d\n", err);
+    return false;
+  }
+
+  demo->block_offset = 0;
+  demo->message = header->first_message;
+
+  return true;
+}
+
+/**
+ * @brief Seeks to, reads and decompresses the block at the specified file offset.
+ * @return True on success.
+ */
+static bool Demo_ReadBlock(demo_t *demo, int64_t offset) {
+
+  if (!Fs_Seek(demo->file, offset)) {
+    return false;
+  }
+
+  return Demo_ReadBlockHeader(demo) == 1 && Demo_ReadBlockData(demo);
+}
+
+/**
+ * @brief Loads the keyframe index from the end of the demo, if it has one. The file
+ * position is preserved.
+ */
+static void Demo_ReadIndex(demo_t *demo) {
+
+  const int64_t position = Fs_Tell(demo->file);
+  const int64_t length = Fs_FileLength(demo->file);
+
+  demo_index_t index;
+
+  if (length < (int64_t) (sizeof(demo_header_t) + sizeof(index))) {
+    return;
+  }
+
+  if (Fs_Seek(demo->file, length - sizeof(index)) && Fs_Read(demo->file, &index, sizeof(index), 1) == 1) {
+
+    index.ident = LittleLong(index.ident);
+    index.num_keyframes = LittleLong(index.num_keyframes);
+
+    const int64_t size = (int64_t) index.num_keyframes * sizeof(demo_keyframe_t);
+
+    if (index.ident == DEMO_INDEX_ID && index.num_keyframes > 0 &&
+        size <= length - (int64_t) (sizeof(demo_header_t) + sizeof(index))) {
+
+      demo->keyframes = Mem_Link(Mem_Malloc(size), demo);
+
+      if (Fs_Seek(demo->file, length - sizeof(index) - size) &&
+          Fs_Read(demo->file, demo->keyframes, size, 1) == 1) {
+
+        demo->num_keyframes = index.num_keyframes;
+
+        for (size_t i = 0; i < demo->num_keyframes; i++) {
+          demo->keyframes[i].time = LittleLong(demo->keyframes[i].time);
+          demo->keyframes[i].message = LittleLong(demo->keyframes[i].message);
+          demo->keyframes[i].offset = LittleLong(demo->keyframes[i].offset);
+        }
+      } else {
+        Com_Warn("Failed to read demo index\n");
+      }
+    }
+  }
+
+  Fs_Seek(demo->file, position);
+}
+
+/**
+ * @brief Opens the specified demo file for reading, in either format.
+ */
+demo_t *Demo_OpenRead(const char *filename) {
+
+  file_t *file = Fs_OpenRead(filename);
+  if (!file) {
+    return NULL;
+  }
+
+  demo_header_t header;
+  const bool compressed = Fs_Read(file, &header, sizeof(header), 1) == 1 && LittleLong(header.ident) == DEMO_ID;
+
+  if (compressed && LittleLong(header.version) != DEMO_VERSION) {
+    Com_Warn("%s is version %d, not %d\n", filename, LittleLong(header.version), DEMO_VERSION);
+    Fs_Close(file);
+    return NULL;
+  }
+
+  demo_t *demo = Demo_Alloc(file, false, compressed);
+
+  if (compressed) {
+
+    // the first block is the dictionary for all others, so read it right away
+    if (Demo_ReadBlockHeader(demo) != 1 || !Demo_ReadBlockData(demo)) {
+      Demo_Close(demo);
+      return NULL;
+    }
+
+    demo->dictionary = Mem_Link(Mem_Malloc(demo->block_header.size), demo);
+    demo->dictionary_size = demo->block_header.size;
+
+    memcpy(demo->dictionary, demo->block, demo->dictionary_size);
+
+    Demo_ReadIndex(demo);
+  } else {
+    Fs_Seek(file, 0);
+  }
+
+  return demo;
+}
+
+/**
+ * @brief Reads the next message from the demo into `data`.
+ * @param time If not `NULL`, receives the timecode of the message, in milliseconds. Legacy
+ * demos have no timecodes, and were played back one message per server frame.
+ * @return The size of the message, 0 at the end of the demo, or -1 on error.
+ */
+int32_t Demo_ReadMessage(demo_t *demo, void *data, size_t max_size, uint32_t *time) {
+
+  assert(!demo->writing);
+
+  int32_t size;
+
+  if (!demo->compressed) {
+
+    if (Fs_Read(demo->file, &size, sizeof(size), 1) != 1) { // improperly terminated demo file
+      Com_Warn("Failed to read demo file\n");
+      return -1;
+    }
+
+    size = LittleLong(size);
+
+    if (size == -1) { // properly terminated demo file
+      return 0;
+    }
+
+    if (size < 0 || (size_t) size > max_size) { // corrupt demo file
+      Com_Warn("Demo message of %d bytes exceeds %zu\n", size, max_size);
+      return -1;
+    }
+
+    if (Fs_Read(demo->file, data, size, 1) != 1) {
+      Com_Warn("Incomplete or corrupt demo file\n");
+      return -1;
+    }
+
+    demo->time = demo->message * QUETOO_TICK_MILLIS;
+  } else {
+
+    while (demo->block_offset == (size_t) demo->block_header.size) {
+      const int32_t res = Demo_ReadBlockHeader(demo);
+      if (res != 1) {
+        return res;
+      }
+
+      if (!Demo_ReadBlockData(demo)) {
+        return -1;
+      }
+    }
+
+    int32_t timecode;
+
+    if (demo->block_offset + sizeof(size) + sizeof(timecode) > (size_t) demo->block_header.size) {
+      Com_Warn("Corrupt demo block\n");
+      return -1;
+    }
+
+    memcpy(&size, demo->block + demo->block_offset, sizeof(size));
+    size = LittleLong(size);
+
+    demo->block_offset += sizeof(size);
+
+    memcpy(&timecode, demo->block + demo->block_offset, sizeof(timecode));
+    timecode = LittleLong(timecode);
+
+    demo->block_offset += sizeof(timecode);
+
+    if (size < 0 || (size_t) size > max_size ||
+        demo->block_offset + size > (size_t) demo->block_header.size) {
+      Com_Warn("Demo message of %d bytes exceeds %zu\n", size, max_size);
+      return -1;
+    }
+
+    memcpy(data, demo->block + demo->block_offset, size);
+    demo->block_offset += size;
+
+    demo->time = (uint32_t) timecode;
+  }
+
+  if (time) {
+    *time = demo->time;
+  }
+
+  demo->message++;
+  return size;
+}
+
+/**
+ * @brief Binary searches the keyframe index.
+ * @return The last keyframe at or before both `time` and `message`, or `NULL`.
+ */
+static const demo_keyframe_t *Demo_FindKeyframe(const demo_t *demo, uint32_t time, uint32_t message) {
+
+  const demo_keyframe_t *keyframe = NULL;
+
+  size_t lo = 0, hi = demo->num_keyframes;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    const demo_keyframe_t *k = &demo->keyframes[mid];
+
+    if ((uint32_t) k->time <= time && (uint32_t) k->message <= message) {
+      keyframe = k;
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return keyframe;
+}
+
+/**
+ * @brief Positions the demo so that the next message read is the message at `message`.
+ * Compressed demos skip directly to the block containing the message, starting from the
+ * nearest indexed keyframe, while legacy demos are read from the beginning.
+ * @return True on success.
+ */
+bool Demo_Seek(demo_t *demo, uint32_t message) {
+
+  assert(!demo->writing);
+
+  if (demo->compressed) {
+
+    const demo_keyframe_t *keyframe = Demo_FindKeyframe(demo, UINT32_MAX, message);
+
+    if (!Fs_Seek(demo->file, keyframe ? keyframe->offset : (int64_t) sizeof(demo_header_t))) {
+      return false;
+    }
+
+    while (true) {
+      if (Demo_ReadBlockHeader(demo) != 1) {
+        return false;
+      }
+
+      const demo_block_t *header = &demo->block_header;
+
+      if (message < (uint32_t) (header->first_message + header->num_messages)) {
+        if (!Demo_ReadBlockData(demo)) {
+          return false;
+        }
+        break;
+      }
+
+      if (!Fs_Seek(demo->file, Fs_Tell(demo->file) + header->compressed_size)) {
+        return false;
+      }
+    }
+
+    // and skip up to the requested message within the block
+    while (demo->message < message) {
+      int32_t size;
+
+      memcpy(&size, demo->block + demo->block_offset, sizeof(size));
+      demo->block_offset += sizeof(int32_t) * 2 + LittleLong(size);
+
+      if (demo->block_offset > (size_t) demo->block_header.size) {
+        Com_Warn("Corrupt demo block\n");
+        return false;
+      }
+
+      demo->message++;
+    }
+  } else {
+
+    if (!Fs_Seek(demo->file, 0)) {
+      return false;
+    }
+
+    demo->message = 0;
+
+    // read up to the requested message, using the block as scratch
+    while (demo->message < message) {
+      if (Demo_ReadMessage(demo, demo->block, DEMO_BLOCK_SIZE, NULL) <= 0) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Positions the demo at the last keyframe at or before `time`, in milliseconds,
+ * or at the first keyframe if `time` precedes it. Indexed demos resolve this with a single
+ * seek. Demos without an index, e.g. those that were not properly closed, scan their
+ * block headers, and legacy demos are read from the beginning.
+ * @return True on success.
+ */
+bool Demo_SeekTime(demo_t *demo, uint32_t time) {
+
+  assert(!demo->writing);
+
+  if (!demo->compressed) {
+    return Demo_Seek(demo, time / QUETOO_TICK_MILLIS);
+  }
+
+  int64_t offset = -1;
+
+  if (demo->num_keyframes) {
+    const demo_keyframe_t *keyframe = Demo_FindKeyframe(demo, time, UINT32_MAX) ?: demo->keyframes;
+    offset = keyframe->offset;
+  } else {
+
+    if (!Fs_Seek(demo->file, sizeof(demo_header_t))) {
+      return false;
+    }
+
+    while (true) {
+      const int64_t position = Fs_Tell(demo->file);
+
+      if (Demo_ReadBlockHeader(demo) != 1) {
+        break;
+      }
+
+      const demo_block_t *header = &demo->block_header;
+
+      if (header->keyframe) {
+        if (offset == -1 || (uint32_t) header->time <= time) {
+          offset = position;
+        }
+        if ((uint32_t) header->time >= time) {
+          break;
+        }
+      }
+
+      if (!Fs_Seek(demo->file, Fs_Tell(demo->file) + header->compressed_size)) {
+        return false;
+      }
+    }
+  }
+
+  if (offset == -1) {
+    return false;
+  }
+
+  return Demo_ReadBlock(demo, offset);
+}
+
+/**
+ * @return The index of the next message to be written or read.
+ */
+uint32_t Demo_Tell(const demo_t *demo) {
+  return demo->message;
+}
+
+/**
+ * @brief Closes the demo. Demos opened for writing are flushed and terminated, and
+ * compressed demos are followed by their keyframe index.
+ */
+void Demo_Close(demo_t *demo) {
+
+  if (demo->writing) {
+    Demo_Flush(demo);
+
+    const int32_t end = -1;
+    Fs_Write(demo->file, &end, sizeof(end), 1);
+
+    if (demo->compressed) {
+
+      for (size_t i = 0; i < demo->num_keyframes; i++) {
+        const demo_keyframe_t keyframe = {
+          .time = LittleLong(demo->keyframes[i].time),
+          .message = LittleLong(demo->keyframes[i].message),
+          .offset = LittleLong(demo->keyframes[i].offset)
+        };
+
+        Fs_Write(demo->file, &keyframe, sizeof(keyframe), 1);
+      }
+
+      const demo_index_t index = {
+        .num_keyframes = LittleLong((int32_t) demo->num_keyframes),
+        .ident = LittleLong(DEMO_INDEX_ID)
+      };
+
+      Fs_Write(demo->file, &index, sizeof(index), 1);
+    }
+  }
+
+  Fs_Close(demo->file);
+
+  Mem_Free(demo);
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright(c) 1997-2001 id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quetoo.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#pragma once
+
+#include "filesystem.h"
+
+/**
+ * @brief Compressed demos begin with this identifier. Uncompressed demos are the
+ * legacy sequence of length-prefixed messages, terminated by a length of -1.
+ */
+#define DEMO_ID (('Z'<<24)+('M'<<16)+('D'<<8)+'Q')
+#define DEMO_VERSION 2
+
+/**
+ * @brief Compressed demos end with this identifier, preceded by the keyframe index.
+ */
+#define DEMO_INDEX_ID (('X'<<24)+('D'<<16)+('M'<<8)+'Q')
+
+/**
+ * @brief Messages are accumulated into blocks of up to this many bytes, and each block
+ * is compressed independently, so that playback may begin at any block.
+ */
+#define DEMO_BLOCK_SIZE 0x10000
+
+/**
+ * @brief The largest demo message that fits a block, after its length and timecode.
+ */
+#define DEMO_MAX_MESSAGE_SIZE (DEMO_BLOCK_SIZE - sizeof(int32_t) * 2)
+
+/**
+ * @brief Recorders request a full, non-delta frame at this interval, in milliseconds.
+ */
+#define DEMO_KEYFRAME_MILLIS 5000
+
+/**
+ * @brief The on-disk header of a compressed demo.
+ */
+typedef struct {
+  /**
+   * @brief `DEMO_ID`.
+   */
+  int32_t ident;
+
+  /**
+   * @brief `DEMO_VERSION`.
+   */
+  int32_t version;
+} demo_header_t;
+
+/**
+ * @brief The on-disk header of each compressed block. The block's compressed data
+ * follows immediately. A block with a `compressed_size` of -1 terminates the demo.
+ * @details Each block decompresses to a sequence of messages, each prefixed by its length
+ * and timecode. All but the first block are compressed with the first block's messages
+ * as a preset dictionary, since those hold the server data, config strings and entity
+ * baselines that subsequent frames so closely resemble.
+ */
+typedef struct {
+  /**
+   * @brief The size of the compressed block data, in bytes.
+   */
+  int32_t compressed_size;
+
+  /**
+   * @brief The size of the decompressed block, in bytes.
+   */
+  int32_t size;
+
+  /**
+   * @brief The index of the first message in the block.
+   */
+  int32_t first_message;
+
+  /**
+   * @brief The count of messages in the block.
+   */
+  int32_t num_messages;
+
+  /**
+   * @brief The timecode of the first message in the block, in milliseconds.
+   */
+  int32_t time;
+
+  /**
+   * @brief Non-zero if the first message in the block is a keyframe.
+   */
+  int32_t keyframe;
+} demo_block_t;
+
+/**
+ * @brief A keyframe index entry. Keyframes are full, non-delta frames that always begin
+ * a new block, so that playback may resume from them with a single seek.
+ */
+typedef struct {
+  /**
+   * @brief The keyframe's timecode, in milliseconds.
+   */
+  int32_t time;
+
+  /**
+   * @brief The index of the keyframe message.
+   */
+  int32_t message;
+
+  /**
+   * @brief The file offset of the block the keyframe begins.
+   */
+  int32_t offset;
+} demo_keyframe_t;
+
+/**
+ * @brief The on-disk footer of a compressed demo, which follows the keyframe index.
+ * Demos that were not properly closed have no footer, and are indexed by scanning.
+ */
+typedef struct {
+  /**
+   * @brief The count of `demo_keyframe_t` immediately preceding the footer.
+   */
+  int32_t num_keyframes;
+
+  /**
+   * @brief `DEMO_INDEX_ID`.
+   */
+  int32_t ident;
+} demo_index_t;
+
+/**
+ * @brief A demo file opened for writing or reading.
+ */
+typedef struct {
+  /**
+   * @brief The underlying file.
+   */
+  file_t *file;
+
+  /**
+   * @brief True if the demo is opened for writing.
+   */
+  bool writing;
+
+  /**
+   * @brief True if the demo uses the compressed container.
+   */
+  bool compressed;
+
+  /**
+   * @brief The decompressed messages of the current block.
+   */
+  byte *block;
+
+  /**
+   * @brief The header of the current block.
+   */
+  demo_block_t block_header;
+
+  /**
+   * @brief The write or read offset within `block`.
+   */
+  size_t block_offset;
+
+  /**
+   * @brief Scratch space for compressed block data.
+   */
+  byte *compressed_block;
+
+  /**
+   * @brief The preset dictionary, which is the content of the first block.
+   */
+  byte *dictionary;
+
+  /**
+   * @brief The size of `dictionary`, in bytes.
+   */
+  size_t dictionary_size;
+
+  /**
+   * @brief The keyframe index, accumulated while writing or loaded while reading.
+   */
+  demo_keyframe_t *keyframes;
+
+  /**
+   * @brief The count of `keyframes`.
+   */
+  size_t num_keyframes;
+
+  /**
+   * @brief The caller's time at the first message written, to which timecodes are relative.
+   */
+  uint32_t start_time;
+
+  /**
+   * @brief The timecode of the most recently written or read message, in milliseconds.
+   */
+  uint32_t time;
+
+  /**
+   * @brief The index of the next message to be written or read.
+   */
+  uint32_t message;
+} demo_t;
+
+demo_t *Demo_OpenWrite(const char *filename, bool compressed);
+void Demo_WriteMessage(demo_t *demo, const void *data, size_t len, uint32_t time);
+void Demo_WriteKeyframe(demo_t *demo, const void *data, size_t len, uint32_t time);
+bool Demo_KeyframeDue(const demo_t *demo, uint32_t time);
+void Demo_Flush(demo_t *demo);
+demo_t *Demo_OpenRead(const char *filename);
+int32_t Demo_ReadMessage(demo_t *demo, void *data, size_t max_size, uint32_t *time);
+bool Demo_Seek(demo_t *demo, uint32_t message);
+bool Demo_SeekTime(demo_t *demo, uint32_t time);
+uint32_t Demo_Tell(const demo_t *demo);
+void Demo_Close(demo_t *demo);
@@ -305,62 +305,103 @@ void G_NailProjectile(g_entity_t *ent, g_entity_t *attacker, const vec3_t start,
 }
 
 /**
- * @brief Fires a single bullet projectile with randomized spread, dealing damage and emitting impact effects.
+ * @brief Resolves the impact of a bullet trace, dealing damage and emitting impact effects.
  */
-void G_BulletProjectile(g_entity_t *ent, const vec3_t start, const vec3_t dir, int32_t damage, int32_t knockback, int32_t hspread, int32_t vspread, int32_t mod) {
-
-  cm_trace_t tr = gi.Trace(ent->s.origin, start, Box3f(1.f, 1.f, 1.f), ent, CONTENTS_MASK_CLIP_PROJECTILE);
-  if (tr.fraction == 1.0) {
-    vec3_t angles, forward, right, up, end;
-
-    angles = Vec3_Euler(dir);
-    Vec3_Vectors(angles, &forward, &right, &up);
-
-    end = Vec3_Fmaf(start, MAX_WORLD_DIST, forward);
-    end = Vec3_Fmaf(end, RandomRangef(-hspread, hspread), right);
-    end = Vec3_Fmaf(end, RandomRangef(-vspread, vspread), up);
-
-    tr = gi.Trace(start, end, Box3_Zero(), ent, CONTENTS_MASK_CLIP_PROJECTILE);
-
-    G_Tracer(start, tr.end);
-  }
+static void G_BulletProjectile_Impact(g_entity_t *ent, const vec3_t start, const vec3_t dir, cm_trace_t *tr, int32_t damage, int32_t knockback, int32_t mod) {
 
-  if (tr.fraction < 1.0) {
+  if (tr->fraction < 1.0) {
 
     G_Damage(&(g_damage_t) {
-      .target = tr.ent,
+      .target = tr->ent,
       .inflictor = ent,
       .attacker = ent,
       .dir = dir,
-      .point = tr.end,
-      .normal = tr.plane.normal,
+      .point = tr->end,
+      .normal = tr->plane.normal,
       .damage = damage,
       .knockback = knockback,
       .flags = DMG_BULLET,
       .mod = mod
     });
 
-    if (G_IsStructural(&tr)) {
-      G_BulletImpact(&tr);
+    if (G_IsStructural(tr)) {
+      G_BulletImpact(tr);
     }
 
     if (gi.PointContents(start) & CONTENTS_MASK_LIQUID) {
-      G_Ripple(NULL, tr.end, start, 8.f, false);
-      G_BubbleTrail(start, &tr, 12.f);
-    } else if (gi.PointContents(tr.end) & CONTENTS_MASK_LIQUID) {
-      G_Ripple(NULL, start, tr.end, 8.f, true);
-      G_BubbleTrail(start, &tr, 12.f);
+      G_Ripple(NULL, tr->end, start, 8.f, false);
+      G_BubbleTrail(start, tr, 12.f);
+    } else if (gi.PointContents(tr->end) & CONTENTS_MASK_LIQUID) {
+      G_Ripple(NULL, start, tr->end, 8.f, true);
+      G_BubbleTrail(start, tr, 12.f);
     }
   }
 }
 
 /**
- * @brief Fires multiple bullet projectiles to simulate shotgun pellet spread.
+ * @return A randomized bullet end point, spread about the given direction.
+ */
+static vec3_t G_BulletProjectile_End(const vec3_t start, const vec3_t dir, int32_t hspread, int32_t vspread) {
+  vec3_t angles, forward, right, up, end;
+
+  angles = Vec3_Euler(dir);
+  Vec3_Vectors(angles, &forward, &right, &up);
+
+  end = Vec3_Fmaf(start, MAX_WORLD_DIST, forward);
+  end = Vec3_Fmaf(end, RandomRangef(-hspread, hspread), right);
+  end = Vec3_Fmaf(end, RandomRangef(-vspread, vspread), up);
+
+  return end;
+}
+
+/**
+ * @brief Fires a single bullet projectile with randomized spread, dealing damage and emitting impact effects.
+ */
+void G_BulletProjectile(g_entity_t *ent, const vec3_t start, const vec3_t dir, int32_t damage, int32_t knockback, int32_t hspread, int32_t vspread, int32_t mod) {
+
+  cm_trace_t tr = gi.Trace(ent->s.origin, start, Box3f(1.f, 1.f, 1.f), ent, CONTENTS_MASK_CLIP_PROJECTILE);
+  if (tr.fraction == 1.0) {
+
+    const vec3_t end = G_BulletProjectile_End(start, dir, hspread, vspread);
+
+    tr = gi.Trace(start, end, Box3_Zero(), ent, CONTENTS_MASK_CLIP_PROJECTILE);
+
+    G_Tracer(start, tr.end);
+  }
+
+  G_BulletProjectile_Impact(ent, start, dir, &tr, damage, knockback, mod);
+}
+
+/**
+ * @brief Fires multiple bullet projectiles to simulate shotgun pellet spread. The pellets
+ * are traced together with a single `gi.TraceBatch`.
  */
 void G_ShotgunProjectiles(g_entity_t *ent, const vec3_t start, const vec3_t dir, int32_t damage, int32_t knockback, int32_t hspread, int32_t vspread, int32_t count, int32_t mod) {
 
+  const cm_trace_t tr = gi.Trace(ent->s.origin, start, Box3f(1.f, 1.f, 1.f), ent, CONTENTS_MASK_CLIP_PROJECTILE);
+  if (tr.fraction < 1.0) {
+    for (int32_t i = 0; i < count; i++) {
+      cm_trace_t impact = tr;
+      G_BulletProjectile_Impact(ent, start, dir, &impact, damage, knockback, mod);
+    }
+    return;
+  }
+
+  count = Mini(count, MAX_TRACE_BATCH);
+
+  vec3_t starts[count], ends[count];
+  cm_trace_t traces[count];
+
+  for (int32_t i = 0; i < count; i++) {
+    starts[i] = start;
+    ends[i] = G_BulletProjectile_End(start, dir, hspread, vspread);
+  }
+
+  gi.TraceBatch(starts, ends, count, Box3_Zero(), ent, CONTENTS_MASK_CLIP_PROJECTILE, traces);
+
   for (int32_t i = 0; i < count; i++) {
-    G_BulletProjectile(ent, start, dir, damage, knockback, hspread, vspread, mod);
+    G_Tracer(start, traces[i].end);
+    G_BulletProjectile_Impact(ent, start, dir, &traces[i], damage, knockback, mod);
   }
 }
 
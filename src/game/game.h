@@ -25,7 +25,7 @@
 #include "collision/cm_types.h"
 #include <Objectively/Vector.h>
 
-#define GAME_API_VERSION 33
+#define GAME_API_VERSION 34
 
 /**
  * @brief Server flags for `g_entity_t`.
@@ -590,6 +590,21 @@ typedef struct g_import_s {
    */
   cm_trace_t (*Trace)(const vec3_t start, const vec3_t end, const box3_t bounds, const g_entity_t *skip, int32_t contents);
 
+  /**
+   * @brief Collision detection for a batch of traces sharing bounds, skip and contents, as
+   * from a shotgun blast or a fan of visibility rays. The results are identical to `count`
+   * calls to `Trace`, but the entity gather and BSP descent are shared across the batch.
+   *
+   * @param start The start points.
+   * @param end The end points.
+   * @param count The number of traces.
+   * @param bounds The bounding box mins (optional; `Box3_Zero()` for a line trace).
+   * @param skip The entity to skip (e.g. self) (optional).
+   * @param contents The contents mask to intersect with (e.g. `CONTENTS_MASK_SOLID`).
+   * @param traces The resulting traces, which must accommodate `count` traces.
+   */
+  void (*TraceBatch)(const vec3_t *start, const vec3_t *end, size_t count, const box3_t bounds, const g_entity_t *skip, int32_t contents, cm_trace_t *traces);
+
   /**
    * @brief Collision detection. Traces between the two endpoints, impacting
    * the specified entity's planes matching the specified contents mask.
@@ -77,6 +77,20 @@ void Net_WriteLong(mem_buf_t *msg, int32_t c) {
   buf[3] = c >> 24;
 }
 
+/**
+ * @brief Writes an unsigned integer in 7 bit groups to a network message buffer, so
+ * that small values occupy a single byte.
+ */
+void Net_WriteVarInt(mem_buf_t *msg, uint32_t c) {
+
+  while (c >= 0x80) {
+    Net_WriteByte(msg, (c & 0x7f) | 0x80);
+    c >>= 7;
+  }
+
+  Net_WriteByte(msg, c);
+}
+
 /**
  * @brief Writes a null-terminated string to a network message buffer.
  */
@@ -101,18 +115,126 @@ void Net_WriteFloat(mem_buf_t *msg, float v) {
 }
 
 /**
- * @brief Writes a 3D world-space position as three consecutive floats to a network message buffer.
+ * @brief Begins writing a bit stream to the message buffer.
  */
-void Net_WritePosition(mem_buf_t *msg, const vec3_t pos) {
-  Net_WriteFloat(msg, pos.x);
-  Net_WriteFloat(msg, pos.y);
-  Net_WriteFloat(msg, pos.z);
+void Net_BeginBits(net_bits_t *bits, mem_buf_t *msg) {
+  bits->msg = msg;
+  bits->bits = 0;
+  bits->num_bits = 0;
 }
 
 /**
- * @brief Encodes an angle in degrees as a 16-bit integer and writes it to a network message buffer.
+ * @brief Writes the low `count` bits of `value`, up to 32, to the bit stream.
  */
-void Net_WriteAngle(mem_buf_t *msg, float angle) {
+void Net_WriteBits(net_bits_t *bits, uint32_t value, int32_t count) {
+
+  assert(count >= 0 && count <= 32);
+
+  if (count < 32) {
+    value &= (1u << count) - 1;
+  }
+
+  bits->bits |= (uint64_t) value << bits->num_bits;
+  bits->num_bits += count;
+
+  while (bits->num_bits >= 8) {
+    Net_WriteByte(bits->msg, (int32_t) (bits->bits & 0xff));
+    bits->bits >>= 8;
+    bits->num_bits -= 8;
+  }
+}
+
+/**
+ * @brief Writes an unsigned integer to the bit stream in 7 bit groups, so that small
+ * values occupy as few as 8 bits.
+ */
+void Net_WriteBitsVarInt(net_bits_t *bits, uint32_t value) {
+
+  while (value >= 0x80) {
+    Net_WriteBits(bits, (value & 0x7f) | 0x80, 8);
+    value >>= 7;
+  }
+
+  Net_WriteBits(bits, value, 8);
+}
+
+/**
+ * @brief Writes a signed integer to the bit stream as a zig-zag encoded varint, so that
+ * values of small magnitude occupy as few as 8 bits regardless of sign.
+ */
+void Net_WriteBitsSignedVarInt(net_bits_t *bits, int32_t value) {
+  Net_WriteBitsVarInt(bits, ((uint32_t) value << 1) ^ (uint32_t) (value >> 31));
+}
+
+/**
+ * @return The count of bits required to represent any integer in `[min, max]`.
+ */
+static int32_t Net_RangeBits(int32_t min, int32_t max) {
+
+  uint32_t range = (uint32_t) (max - min);
+  int32_t count = 0;
+
+  while (range) {
+    range >>= 1;
+    count++;
+  }
+
+  return count;
+}
+
+/**
+ * @brief Writes an integer known to lie within `[min, max]` to the bit stream, using only
+ * as many bits as that range requires. Values outside of the range are clamped.
+ */
+void Net_WriteBitsRange(net_bits_t *bits, int32_t value, int32_t min, int32_t max) {
+
+  value = Maxi(min, Mini(value, max));
+
+  Net_WriteBits(bits, (uint32_t) (value - min), Net_RangeBits(min, max));
+}
+
+/**
+ * @brief Ends writing a bit stream, flushing any partial byte to the message buffer.
+ */
+void Net_EndBits(net_bits_t *bits) {
+
+  if (bits->num_bits) {
+    Net_WriteByte(bits->msg, (int32_t) (bits->bits & 0xff));
+  }
+
+  bits->bits = 0;
+  bits->num_bits = 0;
+}
+
+/**
+ * @brief Writes a 32-bit float (as its raw integer bit pattern) to the bit stream.
+ */
+static void Net_WriteBitsFloat(net_bits_t *bits, float v) {
+
+  const net_float vec = {
+    .v = v
+  };
+
+  Net_WriteBits(bits, (uint32_t) vec.i, 32);
+}
+
+/**
+ * @brief Writes a vector as three `NET_POSITION_BITS` fixed-point integers to the bit stream.
+ */
+static void Net_WriteBitsVector(net_bits_t *bits, const vec3_t v, float scale) {
+
+  const int32_t max = (1 << (NET_POSITION_BITS - 1)) - 1;
+
+  for (int32_t i = 0; i < 3; i++) {
+    const int32_t q = Clampf(roundf(v.xyz[i] * scale), -max, max);
+    Net_WriteBits(bits, (uint32_t) q, NET_POSITION_BITS);
+  }
+}
+
+/**
+ * @return The 16-bit encoding of the angle in degrees.
+ */
+static uint16_t Net_PackAngle(float angle) {
 
   while (angle < 0.f) {
     angle += 360.f;
@@ -122,7 +244,45 @@ void Net_WriteAngle(mem_buf_t *msg, float angle) {
     angle -= 360.f;
   }
 
-  Net_WriteShort(msg, (uint16_t) ((angle / 360.0f) * UINT16_MAX));
+  return (uint16_t) ((angle / 360.0f) * UINT16_MAX);
+}
+
+/**
+ * @brief Writes three Euler angles as 16-bit integers to the bit stream.
+ */
+static void Net_WriteBitsAngles(net_bits_t *bits, const vec3_t angles) {
+  Net_WriteBits(bits, Net_PackAngle(angles.x), 16);
+  Net_WriteBits(bits, Net_PackAngle(angles.y), 16);
+  Net_WriteBits(bits, Net_PackAngle(angles.z), 16);
+}
+
+/**
+ * @brief Writes a 3D world-space position as quantized fixed-point to a network message buffer.
+ */
+void Net_WritePosition(mem_buf_t *msg, const vec3_t pos) {
+  net_bits_t bits;
+
+  Net_BeginBits(&bits, msg);
+  Net_WriteBitsVector(&bits, pos, NET_POSITION_SCALE);
+  Net_EndBits(&bits);
+}
+
+/**
+ * @brief Writes a velocity as quantized fixed-point to a network message buffer.
+ */
+void Net_WriteVelocity(mem_buf_t *msg, const vec3_t velocity) {
+  net_bits_t bits;
+
+  Net_BeginBits(&bits, msg);
+  Net_WriteBitsVector(&bits, velocity, NET_VELOCITY_SCALE);
+  Net_EndBits(&bits);
+}
+
+/**
+ * @brief Encodes an angle in degrees as a 16-bit integer and writes it to a network message buffer.
+ */
+void Net_WriteAngle(mem_buf_t *msg, float angle) {
+  Net_WriteShort(msg, Net_PackAngle(angle));
 }
 
 /**
@@ -205,39 +365,44 @@ void Net_WriteDeltaMoveCmd(mem_buf_t *msg, const pm_cmd_t *from, const pm_cmd_t
     bits |= CMD_MUZZLE;
   }
 
-  Net_WriteByte(msg, bits);
+  net_bits_t stream;
+  Net_BeginBits(&stream, msg);
+
+  Net_WriteBits(&stream, bits, 8);
 
   if (bits & CMD_ANGLE1) {
-    Net_WriteAngle(msg, to->angles.x);
+    Net_WriteBits(&stream, Net_PackAngle(to->angles.x), 16);
   }
   if (bits & CMD_ANGLE2) {
-    Net_WriteAngle(msg, to->angles.y);
+    Net_WriteBits(&stream, Net_PackAngle(to->angles.y), 16);
   }
   if (bits & CMD_ANGLE3) {
-    Net_WriteAngle(msg, to->angles.z);
+    Net_WriteBits(&stream, Net_PackAngle(to->angles.z), 16);
   }
 
   if (bits & CMD_FORWARD) {
-    Net_WriteShort(msg, to->forward);
+    Net_WriteBitsSignedVarInt(&stream, to->forward);
   }
   if (bits & CMD_RIGHT) {
-    Net_WriteShort(msg, to->right);
+    Net_WriteBitsSignedVarInt(&stream, to->right);
   }
   if (bits & CMD_UP) {
-    Net_WriteShort(msg, to->up);
+    Net_WriteBitsSignedVarInt(&stream, to->up);
   }
 
   if (bits & CMD_BUTTONS) {
-    Net_WriteByte(msg, to->buttons);
+    Net_WriteBits(&stream, to->buttons, 8);
   }
 
   if (bits & CMD_MUZZLE) {
-    Net_WriteChar(msg, (int8_t) to->muzzle.x);
-    Net_WriteChar(msg, (int8_t) to->muzzle.y);
-    Net_WriteChar(msg, (int8_t) to->muzzle.z);
+    Net_WriteBits(&stream, (uint32_t) (int8_t) to->muzzle.x, 8);
+    Net_WriteBits(&stream, (uint32_t) (int8_t) to->muzzle.y, 8);
+    Net_WriteBits(&stream, (uint32_t) (int8_t) to->muzzle.z, 8);
   }
 
-  Net_WriteByte(msg, to->msec);
+  Net_WriteBits(&stream, to->msec, 8);
+
+  Net_EndBits(&stream);
 }
 
 /**
@@ -308,126 +473,147 @@ void Net_WriteDeltaPlayerState(mem_buf_t *msg, const player_state_t *from, const
     bits |= PS_PM_PARAMS;
   }
 
-  Net_WriteLong(msg, bits);
+  uint32_t stat_bits = 0;
+
+  for (int32_t i = 0; i < MAX_STATS; i++) {
+    if (to->stats[i] != from->stats[i]) {
+      stat_bits |= 1U << i;
+    }
+  }
+
+  if (stat_bits) {
+    bits |= PS_STATS;
+  }
+
+  uint64_t inv_bits = 0;
+
+  for (int32_t i = 0; i < MAX_INVENTORY; i++) {
+    if (to->inventory[i] != from->inventory[i]) {
+      inv_bits |= (uint64_t) 1 << i;
+    }
+  }
+
+  if (inv_bits) {
+    bits |= PS_INVENTORY;
+  }
+
+  net_bits_t stream;
+  Net_BeginBits(&stream, msg);
+
+  Net_WriteBitsVarInt(&stream, bits);
 
   if (bits & PS_PM_CLIENT) {
-    Net_WriteByte(msg, to->client);
+    Net_WriteBitsRange(&stream, to->client, 0, MAX_CLIENTS - 1);
   }
 
   if (bits & PS_PM_ENTITY) {
-    Net_WriteShort(msg, to->entity);
+    Net_WriteBitsRange(&stream, to->entity, 0, MAX_ENTITIES - 1);
   }
 
   if (bits & PS_PM_TYPE) {
-    Net_WriteByte(msg, to->pm_state.type);
+    Net_WriteBitsVarInt(&stream, to->pm_state.type);
   }
 
   if (bits & PS_PM_ORIGIN) {
-    Net_WritePosition(msg, to->pm_state.origin);
+    Net_WriteBitsVector(&stream, to->pm_state.origin, NET_POSITION_SCALE);
   }
 
   if (bits & PS_PM_VELOCITY) {
-    Net_WritePosition(msg, to->pm_state.velocity);
+    Net_WriteBitsVector(&stream, to->pm_state.velocity, NET_VELOCITY_SCALE);
   }
 
   if (bits & PS_PM_FLAGS) {
-    Net_WriteShort(msg, to->pm_state.flags);
+    Net_WriteBits(&stream, to->pm_state.flags, 16);
   }
 
   if (bits & PS_PM_TIME) {
-    Net_WriteShort(msg, to->pm_state.time);
+    Net_WriteBitsVarInt(&stream, to->pm_state.time);
   }
 
   if (bits & PS_PM_GRAVITY) {
-    Net_WriteShort(msg, to->pm_state.params.gravity);
+    Net_WriteBitsSignedVarInt(&stream, to->pm_state.params.gravity);
   }
 
   if (bits & PS_PM_VIEW_OFFSET) {
-    Net_WritePosition(msg, to->pm_state.view_offset);
+    Net_WriteBitsVector(&stream, to->pm_state.view_offset, NET_POSITION_SCALE);
   }
 
   if (bits & PS_PM_VIEW_ANGLES) {
-    Net_WriteAngles(msg, to->pm_state.view_angles);
+    Net_WriteBitsAngles(&stream, to->pm_state.view_angles);
   }
 
   if (bits & PS_PM_DELTA_ANGLES) {
-    Net_WriteAngles(msg, to->pm_state.delta_angles);
+    Net_WriteBitsAngles(&stream, to->pm_state.delta_angles);
   }
 
   if (bits & PS_PM_HOOK_POSITION) {
-    Net_WritePosition(msg, to->pm_state.hook_position);
+    Net_WriteBitsVector(&stream, to->pm_state.hook_position, NET_POSITION_SCALE);
   }
 
   if (bits & PS_PM_HOOK_LENGTH) {
-    Net_WriteShort(msg, to->pm_state.hook_length);
+    Net_WriteBitsVarInt(&stream, to->pm_state.hook_length);
   }
 
   if (bits & PS_PM_STEP_OFFSET) {
-    Net_WriteFloat(msg, to->pm_state.step_offset);
+    Net_WriteBitsFloat(&stream, to->pm_state.step_offset);
   }
 
   if (bits & PS_PM_PARAMS) {
-    Net_WriteFloat(msg, to->pm_state.params.gravity_water);
-    Net_WriteFloat(msg, to->pm_state.params.accel_ground);
-    Net_WriteFloat(msg, to->pm_state.params.accel_ground_slick);
-    Net_WriteFloat(msg, to->pm_state.params.accel_air);
-    Net_WriteFloat(msg, to->pm_state.params.accel_water);
-    Net_WriteFloat(msg, to->pm_state.params.accel_spectator);
-    Net_WriteFloat(msg, to->pm_state.params.accel_ladder);
-    Net_WriteFloat(msg, to->pm_state.params.friction_ground);
-    Net_WriteFloat(msg, to->pm_state.params.friction_ground_slick);
-    Net_WriteFloat(msg, to->pm_state.params.friction_air);
-    Net_WriteFloat(msg, to->pm_state.params.friction_water);
-    Net_WriteFloat(msg, to->pm_state.params.friction_spectator);
-    Net_WriteFloat(msg, to->pm_state.params.friction_ladder);
-    Net_WriteFloat(msg, to->pm_state.params.speed_ground);
-    Net_WriteFloat(msg, to->pm_state.params.speed_air);
-    Net_WriteFloat(msg, to->pm_state.params.speed_water);
-    Net_WriteFloat(msg, to->pm_state.params.speed_ladder);
-    Net_WriteFloat(msg, to->pm_state.params.speed_spectator);
-    Net_WriteFloat(msg, to->pm_state.params.speed_stop);
-    Net_WriteFloat(msg, to->pm_state.params.speed_jump);
-    Net_WriteFloat(msg, to->pm_state.params.speed_ducked);
-    Net_WriteFloat(msg, to->pm_state.params.speed_duck_stand);
-    Net_WriteFloat(msg, to->pm_state.params.speed_water_jump);
-  }
-
-  uint32_t stat_bits = 0;
-
-  for (int32_t i = 0; i < MAX_STATS; i++) {
-    if (to->stats[i] != from->stats[i]) {
-      stat_bits |= 1 << i;
+    Net_WriteBitsFloat(&stream, to->pm_state.params.gravity_water);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.accel_ground);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.accel_ground_slick);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.accel_air);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.accel_water);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.accel_spectator);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.accel_ladder);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.friction_ground);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.friction_ground_slick);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.friction_air);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.friction_water);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.friction_spectator);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.friction_ladder);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_ground);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_air);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_water);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_ladder);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_spectator);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_stop);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_jump);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_ducked);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_duck_stand);
+    Net_WriteBitsFloat(&stream, to->pm_state.params.speed_water_jump);
+  }
+
+  // stats and inventory are sent only when something has changed
+
+  if (bits & PS_STATS) {
+    Net_WriteBitsVarInt(&stream, stat_bits);
+
+    for (int32_t i = 0; i < MAX_STATS; i++) {
+      if (stat_bits & (1U << i)) {
+        Net_WriteBitsSignedVarInt(&stream, to->stats[i]);
+      }
     }
   }
 
-  Net_WriteLong(msg, stat_bits);
+  if (bits & PS_INVENTORY) {
+    Net_WriteBitsVarInt(&stream, (uint32_t) (inv_bits & 0xFFFFFFFF));
+    Net_WriteBitsVarInt(&stream, (uint32_t) (inv_bits >> 32));
 
-  for (int32_t i = 0; i < MAX_STATS; i++) {
-    if (stat_bits & (1U << i)) {
-      Net_WriteShort(msg, to->stats[i]);
+    for (int32_t i = 0; i < MAX_INVENTORY; i++) {
+      if (inv_bits & ((uint64_t) 1 << i)) {
+        Net_WriteBitsSignedVarInt(&stream, to->inventory[i]);
+      }
     }
   }
 
-  uint64_t inv_bits = 0;
-
-  for (int32_t i = 0; i < MAX_INVENTORY; i++) {
-    if (to->inventory[i] != from->inventory[i]) {
-      inv_bits |= (uint64_t) 1 << i;
-    }
-  }
-
-  Net_WriteLong(msg, (int32_t) (inv_bits & 0xFFFFFFFF));
-  Net_WriteLong(msg, (int32_t) (inv_bits >> 32));
-
-  for (int32_t i = 0; i < MAX_INVENTORY; i++) {
-    if (inv_bits & ((uint64_t) 1 << i)) {
-      Net_WriteShort(msg, to->inventory[i]);
-    }
-  }
+  Net_EndBits(&stream);
 }
 
 /**
  * @brief Writes an entity's state changes to a net message. Can delta from a baseline or a previous state.
+ * @details The entity number and update bits are written byte-aligned, so that the reader may
+ * resolve the entity and handle `U_REMOVE` before reading the bit-packed fields.
  */
 void Net_WriteDeltaEntity(mem_buf_t *msg, const entity_state_t *from, const entity_state_t *to, bool force) {
 
@@ -505,75 +691,89 @@ void Net_WriteDeltaEntity(mem_buf_t *msg, const entity_state_t *from, const enti
   // write the message
 
   Net_WriteShort(msg, to->number);
-  Net_WriteShort(msg, bits);
+  Net_WriteVarInt(msg, bits);
+
+  net_bits_t stream;
+  Net_BeginBits(&stream, msg);
 
   if (bits & U_STEP_OFFSET) {
-    Net_WriteByte(msg, to->step_offset);
+    Net_WriteBits(&stream, (uint32_t) to->step_offset, 8);
   }
 
   if (bits & U_SPAWN_ID) {
-    Net_WriteByte(msg, to->spawn_id);
+    Net_WriteBits(&stream, to->spawn_id, 8);
   }
 
   if (bits & U_ORIGIN) {
-    Net_WritePosition(msg, to->origin);
+    Net_WriteBitsVector(&stream, to->origin, NET_POSITION_SCALE);
   }
 
   if (bits & U_TERMINATION) {
-    Net_WritePosition(msg, to->termination);
+    Net_WriteBitsVector(&stream, to->termination, NET_POSITION_SCALE);
   }
 
   if (bits & U_ANGLES) {
-    Net_WriteAngles(msg, to->angles);
+    Net_WriteBitsAngles(&stream, to->angles);
   }
 
   if (bits & U_ANIMATIONS) {
-    Net_WriteByte(msg, to->animation1);
-    Net_WriteByte(msg, to->animation2);
+    Net_WriteBits(&stream, to->animation1, 8);
+    Net_WriteBits(&stream, to->animation2, 8);
   }
 
   if (bits & U_EVENT) {
-    Net_WriteByte(msg, to->event);
-    Net_WriteByte(msg, to->event_data);
+    Net_WriteBits(&stream, to->event, 8);
+    Net_WriteBits(&stream, to->event_data, 8);
   }
 
   if (bits & U_EFFECTS) {
-    Net_WriteLong(msg, (int32_t) to->effects);
+    Net_WriteBitsVarInt(&stream, to->effects);
   }
 
   if (bits & U_TRAIL) {
-    Net_WriteByte(msg, to->trail);
+    Net_WriteBitsVarInt(&stream, to->trail);
   }
 
   if (bits & U_MODELS) {
-    Net_WriteByte(msg, to->model1);
-    Net_WriteByte(msg, to->model2);
-    Net_WriteByte(msg, to->model3);
-    Net_WriteByte(msg, to->model4);
+    Net_WriteBits(&stream, to->model1, 8);
+    Net_WriteBits(&stream, to->model2, 8);
+    Net_WriteBits(&stream, to->model3, 8);
+    Net_WriteBits(&stream, to->model4, 8);
   }
 
   if (bits & U_COLOR) {
-    Net_WriteByte(msg, to->color.r);
-    Net_WriteByte(msg, to->color.g);
-    Net_WriteByte(msg, to->color.b);
-    Net_WriteByte(msg, to->color.a);
+    Net_WriteBits(&stream, to->color.r, 8);
+    Net_WriteBits(&stream, to->color.g, 8);
+    Net_WriteBits(&stream, to->color.b, 8);
+    Net_WriteBits(&stream, to->color.a, 8);
   }
 
   if (bits & U_CLIENT) {
-    Net_WriteByte(msg, to->client);
+    Net_WriteBits(&stream, to->client, 8);
   }
 
   if (bits & U_SOUND) {
-    Net_WriteByte(msg, to->sound);
+    Net_WriteBits(&stream, to->sound, 8);
   }
 
   if (bits & U_SOLID) {
-    Net_WriteByte(msg, to->solid);
+    Net_WriteBitsRange(&stream, to->solid, SOLID_NOT, SOLID_BSP);
   }
 
   if (bits & U_BOUNDS) {
-    Net_WriteBounds(msg, to->bounds);
+    const vec3s_t mins = Vec3_CastVec3s(to->bounds.mins);
+    const vec3s_t maxs = Vec3_CastVec3s(to->bounds.maxs);
+
+    for (int32_t i = 0; i < 3; i++) {
+      Net_WriteBitsSignedVarInt(&stream, mins.xyz[i]);
+    }
+
+    for (int32_t i = 0; i < 3; i++) {
+      Net_WriteBitsSignedVarInt(&stream, maxs.xyz[i]);
+    }
   }
+
+  Net_EndBits(&stream);
 }
 
 /**
@@ -662,6 +862,29 @@ int32_t Net_ReadLong(mem_buf_t *msg) {
   return (int32_t) c;
 }
 
+/**
+ * @brief Reads an unsigned varint from a network message buffer.
+ */
+uint32_t Net_ReadVarInt(mem_buf_t *msg) {
+
+  uint32_t c = 0;
+
+  for (int32_t shift = 0; shift < 35; shift += 7) {
+    const int32_t b = Net_ReadByte(msg);
+    if (b == -1) {
+      break;
+    }
+
+    c |= (uint32_t) (b & 0x7f) << shift;
+
+    if (!(b & 0x80)) {
+      break;
+    }
+  }
+
+  return c;
+}
+
 /**
  * @brief Reads a null-terminated string from a network message buffer into a static buffer.
  * @remarks Uses a static buffer; not reentrant.
@@ -719,21 +942,160 @@ float Net_ReadFloat(mem_buf_t *msg) {
 }
 
 /**
- * @brief Reads a 3D world-space position from three consecutive floats in a network message buffer.
+ * @brief Begins reading a bit stream from the message buffer.
  */
-vec3_t Net_ReadPosition(mem_buf_t *msg) {
+void Net_BeginReadingBits(net_bits_t *bits, mem_buf_t *msg) {
+  bits->msg = msg;
+  bits->bits = 0;
+  bits->num_bits = 0;
+}
+
+/**
+ * @brief Reads `count` bits, up to 32, from the bit stream. Reads past the end of the
+ * message yield zeroes, and are detected by the caller as for all other reads.
+ */
+uint32_t Net_ReadBits(net_bits_t *bits, int32_t count) {
+
+  assert(count >= 0 && count <= 32);
+
+  while (bits->num_bits < count) {
+    const int32_t c = Net_ReadByte(bits->msg);
+    bits->bits |= (uint64_t) (c == -1 ? 0 : c) << bits->num_bits;
+    bits->num_bits += 8;
+  }
+
+  uint32_t value = (uint32_t) bits->bits;
+  if (count < 32) {
+    value &= (1u << count) - 1;
+  }
+
+  bits->bits >>= count;
+  bits->num_bits -= count;
+
+  return value;
+}
+
+/**
+ * @brief Reads an unsigned varint from the bit stream.
+ */
+uint32_t Net_ReadBitsVarInt(net_bits_t *bits) {
+
+  uint32_t value = 0;
+
+  for (int32_t shift = 0; shift < 35; shift += 7) {
+    const uint32_t group = Net_ReadBits(bits, 8);
+
+    value |= (group & 0x7f) << shift;
+
+    if (!(group & 0x80)) {
+      break;
+    }
+  }
+
+  return value;
+}
+
+/**
+ * @brief Reads a zig-zag encoded signed varint from the bit stream.
+ */
+int32_t Net_ReadBitsSignedVarInt(net_bits_t *bits) {
+
+  const uint32_t value = Net_ReadBitsVarInt(bits);
+
+  return (int32_t) (value >> 1) ^ -(int32_t) (value & 1);
+}
+
+/**
+ * @brief Reads an integer within `[min, max]` from the bit stream.
+ */
+int32_t Net_ReadBitsRange(net_bits_t *bits, int32_t min, int32_t max) {
+  return min + (int32_t) Net_ReadBits(bits, Net_RangeBits(min, max));
+}
+
+/**
+ * @brief Ends reading a bit stream, discarding the padding of its final byte.
+ */
+void Net_EndReadingBits(net_bits_t *bits) {
+  bits->bits = 0;
+  bits->num_bits = 0;
+}
+
+/**
+ * @brief Reads a 32-bit float (stored as a raw integer bit pattern) from the bit stream.
+ */
+static float Net_ReadBitsFloat(net_bits_t *bits) {
+
+  const net_float vec = {
+    .i = (int32_t) Net_ReadBits(bits, 32)
+  };
+
+  return vec.v;
+}
+
+/**
+ * @brief Reads a vector of three `NET_POSITION_BITS` fixed-point integers from the bit stream.
+ */
+static vec3_t Net_ReadBitsVector(net_bits_t *bits, float scale) {
+
+  vec3_t v;
+
+  for (int32_t i = 0; i < 3; i++) {
+    const uint32_t u = Net_ReadBits(bits, NET_POSITION_BITS) << (32 - NET_POSITION_BITS);
+    v.xyz[i] = (((int32_t) u) >> (32 - NET_POSITION_BITS)) / scale;
+  }
+
+  return v;
+}
+
+/**
+ * @return The angle in degrees for the given 16-bit encoding.
+ */
+static float Net_UnpackAngle(int32_t angle) {
+  return (int16_t) angle * 360.f / UINT16_MAX;
+}
+
+/**
+ * @brief Reads three 16-bit encoded Euler angles from the bit stream.
+ */
+static vec3_t Net_ReadBitsAngles(net_bits_t *bits) {
   return (vec3_t) {
-    .x = Net_ReadFloat(msg),
-    .y = Net_ReadFloat(msg),
-    .z = Net_ReadFloat(msg)
+    .x = Net_UnpackAngle(Net_ReadBits(bits, 16)),
+    .y = Net_UnpackAngle(Net_ReadBits(bits, 16)),
+    .z = Net_UnpackAngle(Net_ReadBits(bits, 16))
   };
 }
 
+/**
+ * @brief Reads a quantized 3D world-space position from a network message buffer.
+ */
+vec3_t Net_ReadPosition(mem_buf_t *msg) {
+  net_bits_t bits;
+
+  Net_BeginReadingBits(&bits, msg);
+  const vec3_t pos = Net_ReadBitsVector(&bits, NET_POSITION_SCALE);
+  Net_EndReadingBits(&bits);
+
+  return pos;
+}
+
+/**
+ * @brief Reads a quantized velocity from a network message buffer.
+ */
+vec3_t Net_ReadVelocity(mem_buf_t *msg) {
+  net_bits_t bits;
+
+  Net_BeginReadingBits(&bits, msg);
+  const vec3_t velocity = Net_ReadBitsVector(&bits, NET_VELOCITY_SCALE);
+  Net_EndReadingBits(&bits);
+
+  return velocity;
+}
+
 /**
  * @brief Reads a 16-bit encoded angle and converts it to degrees.
  */
 float Net_ReadAngle(mem_buf_t *msg) {
-  return Net_ReadShort(msg) * 360.f / UINT16_MAX;
+  return Net_UnpackAngle(Net_ReadShort(msg));
 }
 
 /**
@@ -784,39 +1146,44 @@ void Net_ReadDeltaMoveCmd(mem_buf_t *msg, const pm_cmd_t *from, pm_cmd_t *to) {
 
   *to = *from;
 
-  const uint8_t bits = Net_ReadByte(msg);
+  net_bits_t stream;
+  Net_BeginReadingBits(&stream, msg);
+
+  const uint8_t bits = Net_ReadBits(&stream, 8);
 
   if (bits & CMD_ANGLE1) {
-    to->angles.x = Net_ReadAngle(msg);
+    to->angles.x = Net_UnpackAngle(Net_ReadBits(&stream, 16));
   }
   if (bits & CMD_ANGLE2) {
-    to->angles.y = Net_ReadAngle(msg);
+    to->angles.y = Net_UnpackAngle(Net_ReadBits(&stream, 16));
   }
   if (bits & CMD_ANGLE3) {
-    to->angles.z = Net_ReadAngle(msg);
+    to->angles.z = Net_UnpackAngle(Net_ReadBits(&stream, 16));
   }
 
   if (bits & CMD_FORWARD) {
-    to->forward = Net_ReadShort(msg);
+    to->forward = Net_ReadBitsSignedVarInt(&stream);
   }
   if (bits & CMD_RIGHT) {
-    to->right = Net_ReadShort(msg);
+    to->right = Net_ReadBitsSignedVarInt(&stream);
   }
   if (bits & CMD_UP) {
-    to->up = Net_ReadShort(msg);
+    to->up = Net_ReadBitsSignedVarInt(&stream);
   }
 
   if (bits & CMD_BUTTONS) {
-    to->buttons = Net_ReadByte(msg);
+    to->buttons = Net_ReadBits(&stream, 8);
   }
 
   if (bits & CMD_MUZZLE) {
-    to->muzzle.x = Net_ReadChar(msg);
-    to->muzzle.y = Net_ReadChar(msg);
-    to->muzzle.z = Net_ReadChar(msg);
+    to->muzzle.x = (int8_t) Net_ReadBits(&stream, 8);
+    to->muzzle.y = (int8_t) Net_ReadBits(&stream, 8);
+    to->muzzle.z = (int8_t) Net_ReadBits(&stream, 8);
   }
 
-  to->msec = Net_ReadByte(msg);
+  to->msec = Net_ReadBits(&stream, 8);
+
+  Net_EndReadingBits(&stream);
 }
 
 /**
@@ -826,110 +1193,120 @@ void Net_ReadDeltaPlayerState(mem_buf_t *msg, const player_state_t *from, player
 
   *to = *from;
 
-  const uint32_t bits = Net_ReadLong(msg);
+  net_bits_t stream;
+  Net_BeginReadingBits(&stream, msg);
+
+  const uint32_t bits = Net_ReadBitsVarInt(&stream);
 
   if (bits & PS_PM_CLIENT) {
-    to->client = Net_ReadByte(msg);
+    to->client = Net_ReadBitsRange(&stream, 0, MAX_CLIENTS - 1);
   }
 
   if (bits & PS_PM_ENTITY) {
-    to->entity = Net_ReadShort(msg);
+    to->entity = Net_ReadBitsRange(&stream, 0, MAX_ENTITIES - 1);
   }
 
   if (bits & PS_PM_TYPE) {
-    to->pm_state.type = Net_ReadByte(msg);
+    to->pm_state.type = Net_ReadBitsVarInt(&stream);
   }
 
   if (bits & PS_PM_ORIGIN) {
-    to->pm_state.origin = Net_ReadPosition(msg);
+    to->pm_state.origin = Net_ReadBitsVector(&stream, NET_POSITION_SCALE);
   }
 
   if (bits & PS_PM_VELOCITY) {
-    to->pm_state.velocity = Net_ReadPosition(msg);
+    to->pm_state.velocity = Net_ReadBitsVector(&stream, NET_VELOCITY_SCALE);
   }
 
   if (bits & PS_PM_FLAGS) {
-    to->pm_state.flags = Net_ReadShort(msg);
+    to->pm_state.flags = Net_ReadBits(&stream, 16);
   }
 
   if (bits & PS_PM_TIME) {
-    to->pm_state.time = Net_ReadShort(msg);
+    to->pm_state.time = Net_ReadBitsVarInt(&stream);
   }
 
   if (bits & PS_PM_GRAVITY) {
-    to->pm_state.params.gravity = Net_ReadShort(msg);
+    to->pm_state.params.gravity = Net_ReadBitsSignedVarInt(&stream);
   }
 
   if (bits & PS_PM_VIEW_OFFSET) {
-    to->pm_state.view_offset = Net_ReadPosition(msg);
+    to->pm_state.view_offset = Net_ReadBitsVector(&stream, NET_POSITION_SCALE);
   }
 
   if (bits & PS_PM_VIEW_ANGLES) {
-    to->pm_state.view_angles = Net_ReadAngles(msg);
+    to->pm_state.view_angles = Net_ReadBitsAngles(&stream);
   }
 
   if (bits & PS_PM_DELTA_ANGLES) {
-    to->pm_state.delta_angles = Net_ReadAngles(msg);
+    to->pm_state.delta_angles = Net_ReadBitsAngles(&stream);
   }
 
   if (bits & PS_PM_HOOK_POSITION) {
-    to->pm_state.hook_position = Net_ReadPosition(msg);
+    to->pm_state.hook_position = Net_ReadBitsVector(&stream, NET_POSITION_SCALE);
   }
 
   if (bits & PS_PM_HOOK_LENGTH) {
-    to->pm_state.hook_length = Net_ReadShort(msg);
+    to->pm_state.hook_length = Net_ReadBitsVarInt(&stream);
   }
 
   if (bits & PS_PM_STEP_OFFSET) {
-    to->pm_state.step_offset = Net_ReadFloat(msg);
+    to->pm_state.step_offset = Net_ReadBitsFloat(&stream);
   }
 
   if (bits & PS_PM_PARAMS) {
-    to->pm_state.params.gravity_water = Net_ReadFloat(msg);
-    to->pm_state.params.accel_ground = Net_ReadFloat(msg);
-    to->pm_state.params.accel_ground_slick = Net_ReadFloat(msg);
-    to->pm_state.params.accel_air = Net_ReadFloat(msg);
-    to->pm_state.params.accel_water = Net_ReadFloat(msg);
-    to->pm_state.params.accel_spectator = Net_ReadFloat(msg);
-    to->pm_state.params.accel_ladder = Net_ReadFloat(msg);
-    to->pm_state.params.friction_ground = Net_ReadFloat(msg);
-    to->pm_state.params.friction_ground_slick = Net_ReadFloat(msg);
-    to->pm_state.params.friction_air = Net_ReadFloat(msg);
-    to->pm_state.params.friction_water = Net_ReadFloat(msg);
-    to->pm_state.params.friction_spectator = Net_ReadFloat(msg);
-    to->pm_state.params.friction_ladder = Net_ReadFloat(msg);
-    to->pm_state.params.speed_ground = Net_ReadFloat(msg);
-    to->pm_state.params.speed_air = Net_ReadFloat(msg);
-    to->pm_state.params.speed_water = Net_ReadFloat(msg);
-    to->pm_state.params.speed_ladder = Net_ReadFloat(msg);
-    to->pm_state.params.speed_spectator = Net_ReadFloat(msg);
-    to->pm_state.params.speed_stop = Net_ReadFloat(msg);
-    to->pm_state.params.speed_jump = Net_ReadFloat(msg);
-    to->pm_state.params.speed_ducked = Net_ReadFloat(msg);
-    to->pm_state.params.speed_duck_stand = Net_ReadFloat(msg);
-    to->pm_state.params.speed_water_jump = Net_ReadFloat(msg);
-  }
-
-  const int32_t stat_bits = Net_ReadLong(msg);
-
-  for (int32_t i = 0; i < MAX_STATS; i++) {
-    if (stat_bits & (1U << i)) {
-      to->stats[i] = Net_ReadShort(msg);
+    to->pm_state.params.gravity_water = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.accel_ground = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.accel_ground_slick = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.accel_air = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.accel_water = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.accel_spectator = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.accel_ladder = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.friction_ground = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.friction_ground_slick = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.friction_air = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.friction_water = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.friction_spectator = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.friction_ladder = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_ground = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_air = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_water = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_ladder = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_spectator = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_stop = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_jump = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_ducked = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_duck_stand = Net_ReadBitsFloat(&stream);
+    to->pm_state.params.speed_water_jump = Net_ReadBitsFloat(&stream);
+  }
+
+  if (bits & PS_STATS) {
+    const uint32_t stat_bits = Net_ReadBitsVarInt(&stream);
+
+    for (int32_t i = 0; i < MAX_STATS; i++) {
+      if (stat_bits & (1U << i)) {
+        to->stats[i] = Net_ReadBitsSignedVarInt(&stream);
+      }
     }
   }
 
-  const uint64_t inv_bits = (uint64_t) (uint32_t) Net_ReadLong(msg) |
-                            ((uint64_t) (uint32_t) Net_ReadLong(msg) << 32);
+  if (bits & PS_INVENTORY) {
+    const uint64_t inv_bits = (uint64_t) Net_ReadBitsVarInt(&stream) |
+                              ((uint64_t) Net_ReadBitsVarInt(&stream) << 32);
 
-  for (int32_t i = 0; i < MAX_INVENTORY; i++) {
-    if (inv_bits & ((uint64_t) 1 << i)) {
-      to->inventory[i] = Net_ReadShort(msg);
+    for (int32_t i = 0; i < MAX_INVENTORY; i++) {
+      if (inv_bits & ((uint64_t) 1 << i)) {
+        to->inventory[i] = Net_ReadBitsSignedVarInt(&stream);
+      }
     }
   }
+
+  Net_EndReadingBits(&stream);
 }
 
 /**
  * @brief Reads delta-compressed entity state fields into `to`, starting from the baseline in `from`.
+ * @details The entity number and update bits have already been read by the caller.
  */
 void Net_ReadDeltaEntity(mem_buf_t *msg, const entity_state_t *from, entity_state_t *to,
                          int16_t number, uint16_t bits) {
@@ -938,74 +1315,85 @@ void Net_ReadDeltaEntity(mem_buf_t *msg, const entity_state_t *from, entity_stat
 
   to->number = number;
 
+  net_bits_t stream;
+  Net_BeginReadingBits(&stream, msg);
+
   if (bits & U_STEP_OFFSET) {
-    to->step_offset = Net_ReadByte(msg);
+    to->step_offset = (int8_t) Net_ReadBits(&stream, 8);
   }
 
   if (bits & U_SPAWN_ID) {
-    to->spawn_id = Net_ReadByte(msg);
+    to->spawn_id = Net_ReadBits(&stream, 8);
   }
 
   if (bits & U_ORIGIN) {
-    to->origin = Net_ReadPosition(msg);
+    to->origin = Net_ReadBitsVector(&stream, NET_POSITION_SCALE);
   }
 
   if (bits & U_TERMINATION) {
-    to->termination = Net_ReadPosition(msg);
+    to->termination = Net_ReadBitsVector(&stream, NET_POSITION_SCALE);
   }
 
   if (bits & U_ANGLES) {
-    to->angles = Net_ReadAngles(msg);
+    to->angles = Net_ReadBitsAngles(&stream);
   }
 
   if (bits & U_ANIMATIONS) {
-    to->animation1 = Net_ReadByte(msg);
-    to->animation2 = Net_ReadByte(msg);
+    to->animation1 = Net_ReadBits(&stream, 8);
+    to->animation2 = Net_ReadBits(&stream, 8);
   }
 
   if (bits & U_EVENT) {
-    to->event = Net_ReadByte(msg);
-    to->event_data = Net_ReadByte(msg);
+    to->event = Net_ReadBits(&stream, 8);
+    to->event_data = Net_ReadBits(&stream, 8);
   } else {
     to->event = 0;
     to->event_data = 0;
   }
 
   if (bits & U_EFFECTS) {
-    to->effects = (uint32_t) Net_ReadLong(msg);
+    to->effects = Net_ReadBitsVarInt(&stream);
   }
 
   if (bits & U_TRAIL) {
-    to->trail = Net_ReadByte(msg);
+    to->trail = Net_ReadBitsVarInt(&stream);
   }
 
   if (bits & U_MODELS) {
-    to->model1 = Net_ReadByte(msg);
-    to->model2 = Net_ReadByte(msg);
-    to->model3 = Net_ReadByte(msg);
-    to->model4 = Net_ReadByte(msg);
+    to->model1 = Net_ReadBits(&stream, 8);
+    to->model2 = Net_ReadBits(&stream, 8);
+    to->model3 = Net_ReadBits(&stream, 8);
+    to->model4 = Net_ReadBits(&stream, 8);
   }
 
   if (bits & U_COLOR) {
-    to->color.r = Net_ReadByte(msg);
-    to->color.g = Net_ReadByte(msg);
-    to->color.b = Net_ReadByte(msg);
-    to->color.a = Net_ReadByte(msg);
+    to->color.r = Net_ReadBits(&stream, 8);
+    to->color.g = Net_ReadBits(&stream, 8);
+    to->color.b = Net_ReadBits(&stream, 8);
+    to->color.a = Net_ReadBits(&stream, 8);
   }
 
   if (bits & U_CLIENT) {
-    to->client = Net_ReadByte(msg);
+    to->client = Net_ReadBits(&stream, 8);
   }
 
   if (bits & U_SOUND) {
-    to->sound = Net_ReadByte(msg);
+    to->sound = Net_ReadBits(&stream, 8);
   }
 
   if (bits & U_SOLID) {
-    to->solid = Net_ReadByte(msg);
+    to->solid = Net_ReadBitsRange(&stream, SOLID_NOT, SOLID_BSP);
   }
 
   if (bits & U_BOUNDS) {
-    to->bounds = Net_ReadBounds(msg);
+    for (int32_t i = 0; i < 3; i++) {
+      to->bounds.mins.xyz[i] = (int16_t) Net_ReadBitsSignedVarInt(&stream);
+    }
+
+    for (int32_t i = 0; i < 3; i++) {
+      to->bounds.maxs.xyz[i] = (int16_t) Net_ReadBitsSignedVarInt(&stream);
+    }
   }
+
+  Net_EndReadingBits(&stream);
 }
@@ -41,6 +41,20 @@
 #define PS_PM_HOOK_LENGTH   (1 << 12)
 #define PS_PM_STEP_OFFSET   (1 << 13)
 #define PS_PM_PARAMS        (1 << 14)
+#define PS_STATS            (1 << 15)
+#define PS_INVENTORY        (1 << 16)
+
+/**
+ * @brief Positions are written as 1/32 unit fixed-point, 21 bits per axis, which spans
+ * several times the world bounds. The three axes are packed into 64 bits.
+ */
+#define NET_POSITION_BITS  21
+#define NET_POSITION_SCALE 32.f
+
+/**
+ * @brief Velocities are written as 1/8 unit per second fixed-point, packed as positions.
+ */
+#define NET_VELOCITY_SCALE 8.f
 
 /**
  * @brief Delta compression flags for `user_cmd_t`.
@@ -56,25 +70,64 @@
 
 /**
  * @brief These flags indicate which fields in a given `entity_state_t` must be
- * written or read for delta compression from one snapshot to the next.
+ * written or read for delta compression from one snapshot to the next. They are
+ * written as a varint, so the most frequently sent flags come first.
  */
 #define U_ORIGIN      (1 << 0)
-#define U_TERMINATION (1 << 1)
-#define U_ANGLES      (1 << 2)
-#define U_ANIMATIONS  (1 << 3)
-#define U_EVENT       (1 << 4)
-#define U_EFFECTS     (1 << 5)
-#define U_TRAIL       (1 << 6)
-#define U_MODELS      (1 << 7)
-#define U_COLOR       (1 << 8)
-#define U_CLIENT      (1 << 9)
-#define U_SOUND       (1 << 10)
-#define U_SOLID       (1 << 11)
-#define U_BOUNDS      (1 << 12)
-#define U_REMOVE      (1 << 13)
+#define U_ANGLES      (1 << 1)
+#define U_ANIMATIONS  (1 << 2)
+#define U_EVENT       (1 << 3)
+#define U_REMOVE      (1 << 4)
+#define U_SOUND       (1 << 5)
+#define U_TERMINATION (1 << 6)
+#define U_EFFECTS     (1 << 7)
+#define U_TRAIL       (1 << 8)
+#define U_MODELS      (1 << 9)
+#define U_COLOR       (1 << 10)
+#define U_CLIENT      (1 << 11)
+#define U_SOLID       (1 << 12)
+#define U_BOUNDS      (1 << 13)
 #define U_SPAWN_ID    (1 << 14)
 #define U_STEP_OFFSET (1 << 15)
 
+/**
+ * @brief A bit-granular cursor over a message buffer. Bits are packed least significant
+ * first, and a bit stream always occupies a whole number of bytes in the message.
+ */
+typedef struct {
+  /**
+   * @brief The message buffer being written or read.
+   */
+  mem_buf_t *msg;
+
+  /**
+   * @brief Bits pending a write to, or remaining from a read of, `msg`.
+   */
+  uint64_t bits;
+
+  /**
+   * @brief The count of valid bits in `bits`.
+   */
+  int32_t num_bits;
+} net_bits_t;
+
+/**
+ * @brief Bit stream writing and reading facilities.
+ */
+void Net_BeginBits(net_bits_t *bits, mem_buf_t *msg);
+void Net_WriteBits(net_bits_t *bits, uint32_t value, int32_t count);
+void Net_WriteBitsVarInt(net_bits_t *bits, uint32_t value);
+void Net_WriteBitsSignedVarInt(net_bits_t *bits, int32_t value);
+void Net_WriteBitsRange(net_bits_t *bits, int32_t value, int32_t min, int32_t max);
+void Net_EndBits(net_bits_t *bits);
+
+void Net_BeginReadingBits(net_bits_t *bits, mem_buf_t *msg);
+uint32_t Net_ReadBits(net_bits_t *bits, int32_t count);
+uint32_t Net_ReadBitsVarInt(net_bits_t *bits);
+int32_t Net_ReadBitsSignedVarInt(net_bits_t *bits);
+int32_t Net_ReadBitsRange(net_bits_t *bits, int32_t min, int32_t max);
+void Net_EndReadingBits(net_bits_t *bits);
+
 /**
  * @brief Message writing and reading facilities.
  */
@@ -83,9 +136,11 @@ void Net_WriteChar(mem_buf_t *msg, int32_t c);
 void Net_WriteByte(mem_buf_t *msg, int32_t c);
 void Net_WriteShort(mem_buf_t *msg, int32_t c);
 void Net_WriteLong(mem_buf_t *msg, int32_t c);
+void Net_WriteVarInt(mem_buf_t *msg, uint32_t c);
 void Net_WriteString(mem_buf_t *msg, const char *s);
 void Net_WriteFloat(mem_buf_t *msg, float f);
 void Net_WritePosition(mem_buf_t *msg, const vec3_t pos);
+void Net_WriteVelocity(mem_buf_t *msg, const vec3_t velocity);
 void Net_WriteAngle(mem_buf_t *msg, float f);
 void Net_WriteAngles(mem_buf_t *msg, const vec3_t angles);
 void Net_WriteDir(mem_buf_t *msg, const vec3_t dir);
@@ -100,10 +155,12 @@ int32_t Net_ReadChar(mem_buf_t *msg);
 int32_t Net_ReadByte(mem_buf_t *msg);
 int32_t Net_ReadShort(mem_buf_t *msg);
 int32_t Net_ReadLong(mem_buf_t *msg);
+uint32_t Net_ReadVarInt(mem_buf_t *msg);
 char *Net_ReadString(mem_buf_t *msg);
 char *Net_ReadStringLine(mem_buf_t *msg);
 float Net_ReadFloat(mem_buf_t *msg);
 vec3_t Net_ReadPosition(mem_buf_t *msg);
+vec3_t Net_ReadVelocity(mem_buf_t *msg);
 float Net_ReadAngle(mem_buf_t *msg);
 vec3_t Net_ReadAngles(mem_buf_t *msg);
 vec3_t Net_ReadDir(mem_buf_t *msg);
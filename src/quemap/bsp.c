@@ -71,6 +71,8 @@ static void PrintBSPFileSizes(void) {
         (int32_t) (bsp_file.num_patches * sizeof(bsp_patch_t)));
 
   Com_Verbose("      voxels        %7i bytes\n", bsp_file.voxels_size);
+
+  Com_Verbose("      vis           %7i bytes\n", bsp_file.vis_size);
 }
 
 /**
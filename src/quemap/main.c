@@ -22,6 +22,7 @@
 #include "manifest.h"
 #include "qbsp.h"
 #include "qlight.h"
+#include "qvis.h"
 #include "qzip.h"
 
 #if defined(_WIN32)
@@ -174,6 +175,9 @@ static void Check_BSP_Options(int32_t argc) {
     } else if (!q_strcmp(Com_Argv(i), "--no-tjunc")) {
       Com_Verbose("no_tjunc = true\n");
       no_tjunc = true;
+    } else if (!q_strcmp(Com_Argv(i), "--no-vis")) {
+      Com_Verbose("no_vis = true\n");
+      no_vis = true;
     } else if (!q_strcmp(Com_Argv(i), "--no-weld")) {
       Com_Verbose("no_weld = true\n");
       no_weld = true;
@@ -237,6 +241,7 @@ Com_Print("-w --wpath <path> - add the write path to the search directory\n");
   Com_Print(" --no-liquid - skip liquid brushes\n");
   Com_Print(" --no-phong - don't apply Phong shading\n");
   Com_Print(" --no-tjunc - don't fix T-junctions\n");
+  Com_Print(" --no-vis - don't calculate cluster visibility\n");
   Com_Print(" --no-weld - don't weld vertices\n");
   Com_Print(" --only-ents - only update the entity string from the .map\n");
   Com_Print("\n");
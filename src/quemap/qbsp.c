@@ -27,6 +27,7 @@
 #include "material.h"
 #include "patch.h"
 #include "portal.h"
+#include "qvis.h"
 #include "tjunction.h"
 #include "writebsp.h"
 #include "qbsp.h"
@@ -69,6 +70,14 @@ static void ProcessWorldModel(const entity_t *e, bsp_model_t *out) {
 
   FindPortalBrushSides(tree);
 
+  if (no_vis) {
+    Com_Verbose("Skipping visibility\n");
+  } else if (leaked) {
+    Com_Warn("Map leaked, skipping visibility\n");
+  } else {
+    VIS_Main(tree);
+  }
+
   MakeTreeFaces(tree);
 
   if (!no_merge) {
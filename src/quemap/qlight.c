@@ -97,15 +97,24 @@ static inline void Light_TraceToBrush(cm_trace_data_t *data, const cm_bsp_brush_
 
   bool start_outside = false, end_outside = false;
 
+  float d1s[CM_BRUSH_PLANES(brush->num_brush_sides)], d2s[CM_BRUSH_PLANES(brush->num_brush_sides)];
+
+  const bool packed = Cm_BrushSideDistances(brush, data->start, data->end, Box3_Zero(), d1s, d2s);
+
   const cm_bsp_brush_side_t *s = brush->brush_sides + brush->num_brush_sides - 1;
   for (int32_t i = brush->num_brush_sides - 1; i >= 0; i--, s--) {
 
-    cm_bsp_plane_t *p = s->plane;
+    const cm_bsp_plane_t *p = s->plane;
 
-    const float dist = p->dist;
+    float d1, d2;
 
-    const float d1 = Vec3_Dot(data->start, p->normal) - dist;
-    const float d2 = Vec3_Dot(data->end, p->normal) - dist;
+    if (packed) {
+      d1 = d1s[i];
+      d2 = d2s[i];
+    } else {
+      d1 = Vec3_Dot(data->start, p->normal) - p->dist;
+      d2 = Vec3_Dot(data->end, p->normal) - p->dist;
+    }
 
     if (d1 > 0.f) {
       start_outside = true;
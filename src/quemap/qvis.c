@@ -0,0 +1,498 @@
+/*
+ * Copyright(c) 1997-2001 id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quetoo.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "bsp.h"
+#include "portal.h"
+#include "qvis.h"
+
+bool no_vis = false;
+
+/**
+ * @brief A directed portal, leading from one cluster into another.
+ */
+typedef struct {
+
+  /**
+   * @brief The portal plane normal, facing into the cluster this portal leads to.
+   */
+  vec3_t normal;
+
+  /**
+   * @brief The portal plane distance.
+   */
+  double dist;
+
+  /**
+   * @brief The cluster this portal leads to.
+   */
+  int32_t cluster;
+
+  /**
+   * @brief The portal winding, shared by both directions of the source portal.
+   */
+  const cm_winding_t *winding;
+
+  /**
+   * @brief Bit vector of the portals which lie in front of this portal.
+   */
+  byte *front;
+
+  /**
+   * @brief Bit vector of the portals which may be seen through this portal.
+   */
+  byte *flood;
+} vis_portal_t;
+
+/**
+ * @brief Clusters are connected regions of non-solid leafs within a single block.
+ */
+typedef struct {
+
+  /**
+   * @brief The portals leading out of this cluster.
+   */
+  vis_portal_t **portals;
+
+  /**
+   * @brief The count of portals leading out of this cluster.
+   */
+  int32_t num_portals;
+} vis_cluster_t;
+
+static struct {
+  vis_cluster_t *clusters;
+  int32_t num_clusters;
+
+  vis_portal_t *portals;
+  int32_t num_portals;
+
+  int32_t portal_bytes;
+  int32_t cluster_bytes;
+  int32_t cluster_longs;
+
+  byte *pvs;
+  byte *phs;
+} vis;
+
+#define VIS_TEST(bits, n) ((bits)[(n) >> 3] & (1 << ((n) & 7)))
+#define VIS_SET(bits, n) ((bits)[(n) >> 3] |= (1 << ((n) & 7)))
+
+/**
+ * @return True if the node is a leaf that may be seen into.
+ */
+static inline bool VisibleLeaf(const node_t *node) {
+  return node->plane == PLANE_LEAF && !(node->contents & CONTENTS_SOLID);
+}
+
+/**
+ * @return The `CONTENTS_BLOCK` node enclosing the given leaf.
+ */
+static const node_t *BlockForLeaf(const node_t *leaf) {
+
+  const node_t *node = leaf;
+  while (node->parent) {
+    node = node->parent;
+    if (node->contents == CONTENTS_BLOCK) {
+      break;
+    }
+  }
+
+  return node;
+}
+
+/**
+ * @brief Floods the cluster number through all connected, visible leafs within the block.
+ */
+static void ClusterLeaf_r(node_t *leaf, const node_t *block, int32_t cluster) {
+  int32_t s;
+
+  leaf->cluster = cluster;
+
+  for (const portal_t *p = leaf->portals; p; p = p->next[s]) {
+    s = (p->nodes[1] == leaf);
+
+    if (!p->on_node) {
+      continue; // edge of world
+    }
+
+    node_t *other = p->nodes[!s];
+    if (other->cluster != -1 || !VisibleLeaf(other)) {
+      continue;
+    }
+
+    if (BlockForLeaf(other) != block) {
+      continue;
+    }
+
+    ClusterLeaf_r(other, block, cluster);
+  }
+}
+
+/**
+ * @brief Assigns a cluster to every visible leaf in the tree.
+ */
+static void ClusterLeafs_r(node_t *node) {
+
+  if (node->plane != PLANE_LEAF) {
+    ClusterLeafs_r(node->children[0]);
+    ClusterLeafs_r(node->children[1]);
+    return;
+  }
+
+  if (node->cluster != -1 || !VisibleLeaf(node)) {
+    return;
+  }
+
+  ClusterLeaf_r(node, BlockForLeaf(node), vis.num_clusters++);
+}
+
+/**
+ * @brief Counts or emits the directed portals leading out of the clusters of all leafs.
+ * @details Each portal separating two clusters is visited once from each of its leafs,
+ * yielding one portal for each direction.
+ */
+static void MakeVisPortals_r(const node_t *node, bool emit) {
+  int32_t s;
+
+  if (node->plane != PLANE_LEAF) {
+    MakeVisPortals_r(node->children[0], emit);
+    MakeVisPortals_r(node->children[1], emit);
+    return;
+  }
+
+  if (node->cluster == -1) {
+    return;
+  }
+
+  vis_cluster_t *cluster = &vis.clusters[node->cluster];
+
+  for (const portal_t *p = node->portals; p; p = p->next[s]) {
+    s = (p->nodes[1] == node);
+
+    if (!p->on_node) {
+      continue;
+    }
+
+    const node_t *other = p->nodes[!s];
+    if (other->cluster == -1 || other->cluster == node->cluster) {
+      continue;
+    }
+
+    if (emit) {
+      vis_portal_t *out = &vis.portals[vis.num_portals];
+
+      // portal planes face the front node, so flip them when leading out the front
+      if (s == 0) {
+        out->normal = Vec3_Negate(p->plane.normal);
+        out->dist = -p->plane.dist;
+      } else {
+        out->normal = p->plane.normal;
+        out->dist = p->plane.dist;
+      }
+
+      out->cluster = other->cluster;
+      out->winding = p->winding;
+
+      cluster->portals[cluster->num_portals] = out;
+    }
+
+    cluster->num_portals++;
+    vis.num_portals++;
+  }
+}
+
+/**
+ * @brief Builds the clusters and their directed portals from the world tree.
+ */
+static void MakeVisPortals(tree_t *tree) {
+
+  vis.num_clusters = 0;
+  ClusterLeafs_r(tree->head_node);
+
+  vis.clusters = Mem_TagMalloc(vis.num_clusters * sizeof(vis_cluster_t), (mem_tag_t) MEM_TAG_VIS);
+
+  vis.num_portals = 0;
+  MakeVisPortals_r(tree->head_node, false);
+
+  vis.portals = Mem_TagMalloc(vis.num_portals * sizeof(vis_portal_t), (mem_tag_t) MEM_TAG_VIS);
+
+  vis_cluster_t *cluster = vis.clusters;
+  for (int32_t i = 0; i < vis.num_clusters; i++, cluster++) {
+    cluster->portals = Mem_TagMalloc(cluster->num_portals * sizeof(vis_portal_t *), (mem_tag_t) MEM_TAG_VIS);
+    cluster->num_portals = 0;
+  }
+
+  vis.num_portals = 0;
+  MakeVisPortals_r(tree->head_node, true);
+
+  vis.portal_bytes = (vis.num_portals + 7) >> 3;
+
+  byte *bits = Mem_TagMalloc(vis.num_portals * vis.portal_bytes * 2, (mem_tag_t) MEM_TAG_VIS);
+
+  vis_portal_t *p = vis.portals;
+  for (int32_t i = 0; i < vis.num_portals; i++, p++) {
+    p->front = bits;
+    bits += vis.portal_bytes;
+    p->flood = bits;
+    bits += vis.portal_bytes;
+  }
+}
+
+/**
+ * @return True if any point of the winding lies in front of the plane.
+ */
+static bool WindingInFront(const cm_winding_t *w, const vec3_t normal, double dist) {
+
+  for (int32_t i = 0; i < w->num_points; i++) {
+    if (Vec3_Dot(w->points[i], normal) - dist > ON_EPSILON) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Floods through the clusters beyond the portal, collecting every portal that lies
+ * in front of it. This is conservative: the true visible set is always a subset.
+ */
+static void FloodPortalVis(vis_portal_t *portal) {
+
+  int32_t *stack = Mem_TagMalloc((vis.num_portals + 1) * sizeof(int32_t), (mem_tag_t) MEM_TAG_VIS);
+  int32_t depth = 0;
+
+  stack[depth++] = portal->cluster;
+
+  while (depth) {
+    const vis_cluster_t *cluster = &vis.clusters[stack[--depth]];
+
+    for (int32_t i = 0; i < cluster->num_portals; i++) {
+      const vis_portal_t *p = cluster->portals[i];
+      const int32_t portal_num = (int32_t) (ptrdiff_t) (p - vis.portals);
+
+      if (!VIS_TEST(portal->front, portal_num) || VIS_TEST(portal->flood, portal_num)) {
+        continue;
+      }
+
+      VIS_SET(portal->flood, portal_num);
+      stack[depth++] = p->cluster;
+    }
+  }
+
+  Mem_Free(stack);
+}
+
+/**
+ * @brief Work function resolving the portals that may be seen through the given portal.
+ */
+static void PortalVis(int32_t portal_num) {
+
+  vis_portal_t *portal = &vis.portals[portal_num];
+
+  const vis_portal_t *p = vis.portals;
+  for (int32_t i = 0; i < vis.num_portals; i++, p++) {
+
+    if (i == portal_num) {
+      continue;
+    }
+
+    // the other portal must lie at least partially in front of this one
+    if (!WindingInFront(p->winding, portal->normal, portal->dist)) {
+      continue;
+    }
+
+    // and this portal must lie at least partially behind the other one
+    if (!WindingInFront(portal->winding, Vec3_Negate(p->normal), -p->dist)) {
+      continue;
+    }
+
+    VIS_SET(portal->front, i);
+  }
+
+  FloodPortalVis(portal);
+}
+
+/**
+ * @brief Work function resolving the potentially visible set of the given cluster.
+ */
+static void ClusterVis(int32_t cluster_num) {
+
+  byte *pvs = vis.pvs + cluster_num * vis.cluster_longs * sizeof(uint64_t);
+
+  VIS_SET(pvs, cluster_num);
+
+  const vis_cluster_t *cluster = &vis.clusters[cluster_num];
+  for (int32_t i = 0; i < cluster->num_portals; i++) {
+    const vis_portal_t *portal = cluster->portals[i];
+
+    VIS_SET(pvs, portal->cluster);
+
+    for (int32_t j = 0; j < vis.portal_bytes; j++) {
+      if (!portal->flood[j]) {
+        continue;
+      }
+      for (int32_t k = j << 3; k < ((j + 1) << 3) && k < vis.num_portals; k++) {
+        if (VIS_TEST(portal->flood, k)) {
+          VIS_SET(pvs, vis.portals[k].cluster);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Work function resolving the potentially hearable set of the given cluster, which is
+ * the union of the potentially visible sets of every cluster it can see.
+ */
+static void ClusterHear(int32_t cluster_num) {
+
+  const byte *pvs = vis.pvs + cluster_num * vis.cluster_longs * sizeof(uint64_t);
+  uint64_t *phs = (uint64_t *) (vis.phs + cluster_num * vis.cluster_longs * sizeof(uint64_t));
+
+  for (int32_t i = 0; i < vis.num_clusters; i++) {
+    if (!VIS_TEST(pvs, i)) {
+      continue;
+    }
+
+    const uint64_t *in = (uint64_t *) (vis.pvs + i * vis.cluster_longs * sizeof(uint64_t));
+    for (int32_t j = 0; j < vis.cluster_longs; j++) {
+      phs[j] |= in[j];
+    }
+  }
+}
+
+/**
+ * @brief Run-length compresses runs of zero bytes in the given cluster bit vector.
+ * @return The compressed size in bytes.
+ */
+static int32_t CompressVis(const byte *in, byte *out) {
+
+  byte *dest = out;
+
+  for (int32_t i = 0; i < vis.cluster_bytes; i++) {
+
+    *dest++ = in[i];
+    if (in[i]) {
+      continue;
+    }
+
+    int32_t run = 1;
+    while (i + 1 < vis.cluster_bytes && !in[i + 1] && run < 255) {
+      run++;
+      i++;
+    }
+
+    *dest++ = run;
+  }
+
+  return (int32_t) (ptrdiff_t) (dest - out);
+}
+
+/**
+ * @brief Compresses the potentially visible and hearable sets into the visibility lump.
+ */
+static void EmitVis(void) {
+
+  const size_t header_size = sizeof(bsp_vis_t) + vis.num_clusters * sizeof(int32_t) * 2;
+
+  byte *data = Mem_TagMalloc(header_size + vis.num_clusters * vis.cluster_bytes * 4, (mem_tag_t) MEM_TAG_VIS);
+  bsp_vis_t *out = (bsp_vis_t *) data;
+
+  out->num_clusters = vis.num_clusters;
+
+  int32_t size = (int32_t) header_size;
+  int32_t visible = 0, hearable = 0;
+
+  for (int32_t i = 0; i < vis.num_clusters; i++) {
+    const byte *pvs = vis.pvs + i * vis.cluster_longs * sizeof(uint64_t);
+    const byte *phs = vis.phs + i * vis.cluster_longs * sizeof(uint64_t);
+
+    for (int32_t j = 0; j < vis.num_clusters; j++) {
+      visible += VIS_TEST(pvs, j) ? 1 : 0;
+      hearable += VIS_TEST(phs, j) ? 1 : 0;
+    }
+
+    out->offsets[i][BSP_VIS_PVS] = size;
+    size += CompressVis(pvs, data + size);
+
+    out->offsets[i][BSP_VIS_PHS] = size;
+    size += CompressVis(phs, data + size);
+  }
+
+  if (size >= MAX_BSP_VIS_SIZE) {
+    Com_Error(ERROR_FATAL, "MAX_BSP_VIS_SIZE\n");
+  }
+
+  bsp_file.vis_size = size;
+  Bsp_AllocLump(&bsp_file, BSP_LUMP_VIS, bsp_file.vis_size);
+  memcpy(bsp_file.vis, data, bsp_file.vis_size);
+
+  Mem_Free(data);
+
+  Com_Verbose("%5i clusters\n", vis.num_clusters);
+  Com_Verbose("%5i portals\n", vis.num_portals);
+  Com_Verbose("%5i average visible clusters\n", visible / vis.num_clusters);
+  Com_Verbose("%5i average hearable clusters\n", hearable / vis.num_clusters);
+  Com_Verbose("%5i bytes compressed visibility\n", size);
+}
+
+/**
+ * @brief `VIS` stage entry point: assigns leafs of the world tree to clusters, and computes
+ * the potentially visible and hearable sets of each cluster from the tree portals.
+ * @details This must run after `FillOutside` and before `EmitNodes`, as the cluster of each
+ * leaf is written along with it.
+ */
+int32_t VIS_Main(tree_t *tree) {
+
+  const uint32_t start = (uint32_t) SDL_GetTicks();
+
+  memset(&vis, 0, sizeof(vis));
+
+  MakeVisPortals(tree);
+
+  if (vis.num_clusters == 0) {
+    Com_Warn("No visible leafs, skipping visibility\n");
+    return 0;
+  }
+
+  vis.cluster_bytes = (vis.num_clusters + 7) >> 3;
+  vis.cluster_longs = (vis.num_clusters + 63) >> 6;
+
+  const size_t size = vis.num_clusters * vis.cluster_longs * sizeof(uint64_t);
+
+  vis.pvs = Mem_TagMalloc(size, (mem_tag_t) MEM_TAG_VIS);
+  vis.phs = Mem_TagMalloc(size, (mem_tag_t) MEM_TAG_VIS);
+
+  Work("Portal visibility", PortalVis, vis.num_portals);
+
+  Work("Cluster visibility", ClusterVis, vis.num_clusters);
+
+  Work("Cluster hearability", ClusterHear, vis.num_clusters);
+
+  EmitVis();
+
+  Mem_FreeTag(MEM_TAG_VIS);
+
+  const uint32_t end = (uint32_t) SDL_GetTicks();
+  Com_Verbose("Computed visibility in %d ms\n", end - start);
+
+  return 0;
+}
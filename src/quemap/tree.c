@@ -35,7 +35,10 @@ node_t *AllocNode(void) {
 
   SDL_AddAtomicInt(&c_active_nodes, 1);
 
-  return Mem_TagMalloc(sizeof(node_t), (mem_tag_t) MEM_TAG_NODE);
+  node_t *node = Mem_TagMalloc(sizeof(node_t), (mem_tag_t) MEM_TAG_NODE);
+  node->cluster = -1;
+
+  return node;
 }
 
 /**
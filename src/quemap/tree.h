@@ -47,6 +47,7 @@ typedef struct node_s {
   int32_t occupied; // 1 or greater can reach entity
   const entity_t *occupant; // for leak file testing
   struct portal_s *portals; // also on nodes during construction
+  int32_t cluster; // -1 = not visible
 } node_t;
 
 node_t *AllocNode(void);
@@ -180,6 +180,7 @@ static int32_t EmitLeaf(node_t *node) {
   bsp_file.num_leafs++;
 
   out->contents = node->contents;
+  out->cluster = node->cluster;
   out->bounds = node->bounds;
 
   // write the leaf_brushes
@@ -425,6 +426,7 @@ void BeginBSPFile(void) {
    */
   bsp_file.num_leafs = 1;
   bsp_file.leafs[0].contents = CONTENTS_SOLID;
+  bsp_file.leafs[0].cluster = -1;
 }
 
 /**
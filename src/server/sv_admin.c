@@ -105,6 +105,28 @@ static void Sv_Demo_f(void) {
   }
 }
 
+/**
+ * @brief Seeks the current demo to the specified time. Times prefixed with `+` or `-`
+ * are relative to the current playback time.
+ */
+static void Sv_DemoSeek_f(void) {
+
+  if (Cmd_Argc() != 2) {
+    Com_Print("Usage: %s <[+|-]seconds>\n", Cmd_Argv(0));
+    return;
+  }
+
+  const char *arg = Cmd_Argv(1);
+  const float seconds = strtof(arg, NULL);
+
+  int32_t time = (int32_t) (seconds * 1000.f);
+  if (*arg == '+' || *arg == '-') {
+    time += (int32_t) sv.demo_time;
+  }
+
+  Sv_SeekDemo(Maxi(time, 0));
+}
+
 /**
  * @brief Map command autocompletion.
  */
@@ -206,6 +228,51 @@ static void Sv_Status_f(void) {
   }
 }
 
+/**
+ * @brief Prints server performance counters for the current level.
+ */
+static void Sv_ServerStats_f(void) {
+
+  if (svs.state == SV_UNINITIALIZED) {
+    Com_Print("No server running\n");
+    return;
+  }
+
+  const sv_stats_t *stats = &sv.stats;
+  const double client_frames = Maxf(stats->client_frames, 1);
+
+  Com_Print("map: %s\n", sv.name);
+  Com_Print("client frames: %u\n", stats->client_frames);
+  Com_Print("entities per client frame: %.1f sent, %.1f culled\n",
+            (stats->frame_entities - stats->frame_entities_culled) / client_frames,
+            stats->frame_entities_culled / client_frames);
+
+  const double send_frames = Maxf(stats->send_frames, 1);
+
+  Com_Print("client frame time: %.2fms built, %.2fms sent\n",
+            stats->frame_build_nanos / send_frames / 1000000.0,
+            stats->frame_transmit_nanos / send_frames / 1000000.0);
+
+  const double box_queries = Maxf(stats->box_queries, 1);
+
+  Com_Print("entity queries: %" PRIu64 ", %.1f nodes visited, %.1f entities tested, %.1f found per query\n",
+            stats->box_queries,
+            stats->box_nodes / box_queries,
+            stats->box_entities_tested / box_queries,
+            stats->box_entities_found / box_queries);
+
+  Com_Print("traces: %" PRIu64 ", %.1f%% cached, %" PRIu64 " cache invalidations\n",
+            stats->trace_queries,
+            100.0 * stats->trace_cache_hits / Maxf(stats->trace_queries, 1),
+            stats->trace_cache_invalidations);
+
+  const char *scopes[SV_MULTICAST_SCOPES] = { "all", "phs", "pvs" };
+  for (int32_t i = 0; i < SV_MULTICAST_SCOPES; i++) {
+    Com_Print("multicast %s: %" PRIu64 " bytes sent, %" PRIu64 " bytes culled\n",
+              scopes[i], stats->multicast_bytes[i], stats->multicast_bytes_culled[i]);
+  }
+}
+
 /**
  * @brief Lists all entities currently in use.
  */
@@ -378,11 +445,14 @@ void Sv_InitAdmin(void) {
   Cmd_Add("status", Sv_Status_f, CMD_SERVER, "Print server status information.");
   Cmd_Add("list_entities", Sv_ListEntities_f, CMD_SERVER, "List all entities in use.");
   Cmd_Add("server_info", Sv_ServerInfo_f, CMD_SERVER, "Print server info settings.");
+  Cmd_Add("server_stats", Sv_ServerStats_f, CMD_SERVER, "Print server performance counters for the current level.");
   Cmd_Add("user_info", Sv_UserInfo_f, CMD_SERVER, "Print information for a given user.");
 
   cmd_t *demo_cmd = Cmd_Add("demo", Sv_Demo_f, CMD_SERVER, "Start playback of the specified demo file");
   Cmd_SetAutocomplete(demo_cmd, Sv_Demo_Autocomplete_f);
 
+  Cmd_Add("demo_seek", Sv_DemoSeek_f, CMD_SERVER, "Seek the current demo to the specified time, in seconds.");
+
   cmd_t *map_cmd = Cmd_Add("map", Sv_Map_f, CMD_SERVER, "Start a server for the specified map.");
   Cmd_SetAutocomplete(map_cmd, Sv_Map_Autocomplete_f);
 
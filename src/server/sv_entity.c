@@ -76,10 +76,8 @@ static void Sv_WriteEntities(sv_client_frame_t *from, sv_client_frame_t *to, mem
     }
 
     if (new_num > old_num) { // the old entity isn't present in the new message
-      const int16_t bits = U_REMOVE;
-
       Net_WriteShort(msg, old_num);
-      Net_WriteShort(msg, bits);
+      Net_WriteVarInt(msg, U_REMOVE);
 
       old_index++;
       continue;
@@ -137,13 +135,143 @@ void Sv_WriteClientFrame(sv_client_t *client, mem_buf_t *msg) {
   Sv_WriteEntities(delta_frame, frame, msg);
 }
 
+/**
+ * @brief Entity culling modes for `sv_cull_entities`.
+ */
+typedef enum {
+  SV_CULL_NONE,
+  SV_CULL_DISTANCE,
+  SV_CULL_VISIBILITY,
+} sv_cull_t;
+
+/**
+ * @brief Entities found visible are held visible for this long before being re-tested,
+ * which amortizes the cost of the visibility test and prevents popping at corners.
+ */
+#define SV_CULL_VISIBLE_MILLIS 250
+
+/**
+ * @return The bounds used to determine the relevance of the entity to clients.
+ */
+static box3_t Sv_RelevanceBounds(const g_entity_t *ent) {
+
+  box3_t bounds;
+
+  if (ent->solid == SOLID_BSP) {
+    bounds = ent->abs_bounds;
+  } else {
+    bounds = Box3_Translate(ent->bounds, ent->s.origin);
+  }
+
+  if (!Vec3_Equal(ent->s.termination, Vec3_Zero())) {
+    bounds = Box3_Append(bounds, ent->s.termination);
+  }
+
+  return bounds;
+}
+
+/**
+ * @return True if the world does not fully occlude `bounds` from `eye`.
+ */
+static bool Sv_BoundsVisible(const vec3_t eye, const box3_t bounds) {
+
+  const vec3_t center = Box3_Center(bounds);
+
+  if (Sv_PointVisible(eye, center)) {
+    return true;
+  }
+
+  // try the nearest point of the bounds too, so that entities peeking around corners are sent
+  const vec3_t nearest = Vec3_Mix(Box3_ClampPoint(bounds, eye), center, .125f);
+
+  return Sv_PointVisible(eye, nearest);
+}
+
+/**
+ * @return True if the entity is plausibly visible or audible to the client, and should
+ * therefore be included in its frame, according to `sv_cull_entities`.
+ */
+static bool Sv_EntityRelevant(sv_client_t *client, const vec3_t eye, int32_t cluster, const g_entity_t *ent) {
+
+  const sv_cull_t cull = (sv_cull_t) sv_cull_entities->integer;
+  if (cull == SV_CULL_NONE) {
+    return true;
+  }
+
+  const g_client_t *cl = client->gclient;
+
+  // the world, the client's own entity and anything it owns are always relevant
+  if (ent->s.number == 0 || ent->s.number == cl->ps.entity || ent->owner == cl->entity) {
+    return true;
+  }
+
+  const box3_t bounds = Sv_RelevanceBounds(ent);
+  const float dist = Vec3_Distance(eye, Box3_ClampPoint(bounds, eye));
+
+  // entities making noise within earshot are relevant, even when they can not be seen
+  if (ent->s.sound || ent->s.event) {
+    if (dist <= sv_cull_sound_distance->value) {
+      if (cull < SV_CULL_VISIBILITY || Sv_EntityInPHS(cluster, ent)) {
+        return true;
+      }
+    }
+  }
+
+  if (dist > sv_cull_distance->value) {
+    return false;
+  }
+
+  if (cull < SV_CULL_VISIBILITY) {
+    return true;
+  }
+
+  if (!Sv_EntityInPVS(cluster, ent)) {
+    return false;
+  }
+
+  if (ent->solid == SOLID_BSP) {
+    return true;
+  }
+
+  uint32_t *visible_time = &client->entity_visible_time[ent->s.number];
+  if (*visible_time > sv.time) {
+    return true;
+  }
+
+  if (Sv_BoundsVisible(eye, bounds)) {
+    *visible_time = sv.time + SV_CULL_VISIBLE_MILLIS;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Reserves a contiguous slice of `count` entity states in `svs.entity_states`.
+ * @return The index of the first reserved entity state.
+ * @remarks This is safe to call from the client frame worker threads.
+ */
+static uint32_t Sv_ReserveEntityStates(uint32_t count) {
+  uint32_t first;
+
+  do {
+    first = SDL_GetAtomicU32(&svs.next_entity_state);
+  } while (!SDL_CompareAndSwapAtomicU32(&svs.next_entity_state, first, first + count));
+
+  return first;
+}
+
 /**
  * @brief Decides which entities are going to be visible to the client and copies off the player state.
+ * @remarks This touches only the client's own state and its reserved slice of `svs.entity_states`,
+ * and so may be called for several clients in parallel.
  */
 void Sv_BuildClientFrame(sv_client_t *client) {
 
   g_client_t *cl = client->gclient;
 
+  client->frame_entities = client->frame_entities_culled = 0;
+
   if (!cl->in_use) {
     return; // not in game yet
   }
@@ -155,9 +283,12 @@ void Sv_BuildClientFrame(sv_client_t *client) {
   // grab the current player_state_t
   frame->ps = cl->ps;
 
+  // resolve the client's view origin and cluster for entity culling
+  const vec3_t eye = Sv_ClientViewOrigin(client);
+  const int32_t cluster = Sv_PointCluster(eye);
+
   // build up the list of relevant entities
-  frame->num_entities = 0;
-  frame->entity_state = svs.next_entity_state;
+  int32_t num_entities = 0;
 
   for (int32_t i = 0; i < sv_max_entities->integer; i++) {
 
@@ -181,10 +312,28 @@ void Sv_BuildClientFrame(sv_client_t *client) {
       if (!ent->s.event && !ent->s.effects && !ent->s.trail && !ent->s.model1 && !ent->s.sound) {
         continue;
       }
+
+      client->frame_entities++;
+
+      // ignore entities which the client can neither see nor hear
+      if (!Sv_EntityRelevant(client, eye, cluster, ent)) {
+        client->frame_entities_culled++;
+        continue;
+      }
     }
 
-    // copy it to the circular entity_state_t array
-    entity_state_t *s = &svs.entity_states[svs.next_entity_state % svs.num_entity_states];
+    client->frame_entity_numbers[num_entities++] = i;
+  }
+
+  // reserve our slice of the circular entity_state_t array, and copy into it
+  frame->num_entities = num_entities;
+  frame->entity_state = Sv_ReserveEntityStates(num_entities);
+
+  for (int32_t i = 0; i < num_entities; i++) {
+
+    const g_entity_t *ent = sv.entities[client->frame_entity_numbers[i]].gent;
+
+    entity_state_t *s = &svs.entity_states[(frame->entity_state + i) % svs.num_entity_states];
 
     *s = ent->s;
 
@@ -192,8 +341,5 @@ void Sv_BuildClientFrame(sv_client_t *client) {
     if (ent->owner == cl->entity) {
       s->solid = SOLID_NOT;
     }
-
-    svs.next_entity_state++;
-    frame->num_entities++;
   }
 }
@@ -371,6 +371,7 @@ void Sv_InitGame(void) {
   import.BoxContents = Sv_BoxContents;
   import.PointInsideBrush = Cm_PointInsideBrush;
   import.Trace = Sv_Trace;
+  import.TraceBatch = Sv_TraceBatch;
   import.Clip = Sv_Clip;
   import.SetModel = Sv_SetModel;
   import.LinkEntity = Sv_LinkEntity;
@@ -146,7 +146,7 @@ static void Sv_ClearState(void) {
   }
 
   if (sv.demo_file) {
-    Fs_Close(sv.demo_file);
+    Demo_Close(sv.demo_file);
   }
 
   memset(&sv, 0, sizeof(sv));
@@ -225,6 +225,9 @@ static void Sv_ReconnectClients(void) {
     // invalidate last frame to force a baseline
     svs.clients[i].last_frame = -1;
     svs.clients[i].last_message = quetoo.ticks;
+
+    // and forget entity visibility, as server time restarts with the level
+    memset(svs.clients[i].entity_visible_time, 0, sizeof(svs.clients[i].entity_visible_time));
   }
 }
 
@@ -272,7 +275,7 @@ static void Sv_LoadMedia(const char *name, const cm_entity_t *props, sv_state_t
   if (state == SV_ACTIVE_DEMO) { // loading a demo
     Cvar_ForceSetString(sv_map->name, "");
 
-    sv.demo_file = Fs_OpenRead(va("demos/%s.demo", sv.name));
+    sv.demo_file = Demo_OpenRead(va("demos/%s.demo", sv.name));
     svs.spawn_count = 0;
 
     Com_Print("  Loaded demo %s.\n", sv.name);
@@ -31,6 +31,10 @@ sv_server_t sv; // per-level server info
 
 sv_client_t *sv_client; // current client
 
+cvar_t *sv_cull_distance;
+cvar_t *sv_cull_entities;
+cvar_t *sv_cull_multicast;
+cvar_t *sv_cull_sound_distance;
 cvar_t *sv_demo_list;
 cvar_t *sv_enforce_time;
 cvar_t *sv_hostname;
@@ -43,6 +47,9 @@ cvar_t *sv_min_clients;
 cvar_t *sv_master;
 cvar_t *sv_public;
 cvar_t *sv_stats_url;
+cvar_t *sv_threads;
+cvar_t *sv_trace_bvh;
+cvar_t *sv_trace_cache;
 cvar_t *sv_timeout;
 
 /**
@@ -183,7 +190,7 @@ static void Sv_Connect_f(void) {
 
   // resolve protocol
   if (version != PROTOCOL_MAJOR) {
-    Netchan_OutOfBandPrint(NS_UDP_SERVER, addr, "print\nServer is version %d.\n", PROTOCOL_MAJOR);
+    Netchan_OutOfBandPrint(NS_UDP_SERVER, addr, "print\nServer is protocol %d, you have %d.\n", PROTOCOL_MAJOR, version);
     return;
   }
 
@@ -816,6 +823,11 @@ void Sv_Frame(const uint32_t msec) {
     }
   }
 
+  if (sv_trace_bvh->modified) {
+    sv_trace_bvh->modified = false;
+    Cm_SetTraceBackend(sv_trace_bvh->integer ? CM_TRACE_BVH : CM_TRACE_BSP);
+  }
+
   // clamp the frame interval to 4 ticks to prevent physics tunneling under heavy load
   frame_delta = Minf(frame_delta, (uint32_t) (QUETOO_TICK_MILLIS * 4));
 
@@ -878,6 +890,10 @@ void Sv_Frame(const uint32_t msec) {
  */
 static void Sv_InitLocal(void) {
 
+  sv_cull_distance = Cvar_Add("sv_cull_distance", "8192", 0, "Entities farther than this from a client are not sent to it, unless they are audible");
+  sv_cull_entities = Cvar_Add("sv_cull_entities", "1", 0, "Culls irrelevant entities from client frames: 0 disables, 1 culls by distance, 2 also culls entities hidden by the world");
+  sv_cull_multicast = Cvar_Add("sv_cull_multicast", "1", 0, "Limits potentially visible and hearable multicast effects to the clients that may perceive them");
+  sv_cull_sound_distance = Cvar_Add("sv_cull_sound_distance", "2048", 0, "Entities with sounds or events within this distance of a client are always sent to it");
   sv_demo_list = Cvar_Add("sv_demo_list", "", CVAR_SERVER_INFO, "A list of demo names to cycle through");
   sv_enforce_time = Cvar_Add("sv_enforce_time", va("%d", CMD_MSEC_MAX_DRIFT_ERRORS), 0, "Prevents the most blatant form of speed cheating, disable at your own risk");
   sv_hostname = Cvar_Add("sv_hostname", "Quetoo", CVAR_SERVER_INFO | CVAR_ARCHIVE, "The server hostname, visible in the server browser");
@@ -890,6 +906,9 @@ static void Sv_InitLocal(void) {
   sv_min_clients = Cvar_Add("sv_min_clients", "0", CVAR_SERVER_INFO, "The minimum number of clients the server will allow");
   sv_public = Cvar_Add("sv_public", "0", CVAR_SERVER_INFO, "Set to 1 to to advertise this server via the master server");
   sv_stats_url = Cvar_Add("sv_stats_url", "https://giblets.quetoo.org", CVAR_ARCHIVE, "URL to POST per-match stats to. Requires sv_public 1. Set to \"\" to disable.");
+  sv_threads = Cvar_Add("sv_threads", "0", 0, "The number of threads used to build client frames. Set to 0 to use the thread pool, or 1 to build frames on the main thread.");
+  sv_trace_bvh = Cvar_Add("sv_trace_bvh", "0", 0, "Traces inline models through a bounding volume hierarchy of their brushes, rather than their BSP tree.");
+  sv_trace_cache = Cvar_Add("sv_trace_cache", "0", 0, "Memoizes identical traces within a server frame.");
   sv_timeout = Cvar_Add("sv_timeout", va("%d", SV_TIMEOUT), 0, "The client connection timeout threshold in seconds");
 
   sv_max_clients->integer = Mini(sv_max_clients->integer, MAX_CLIENTS);
@@ -29,6 +29,10 @@ int32_t Sv_InstallerFrame(const installer_status_t *s);
 void Sv_Frame(const uint32_t msec);
 
 #if defined(__SV_LOCAL_H__)
+extern cvar_t *sv_cull_distance;
+extern cvar_t *sv_cull_entities;
+extern cvar_t *sv_cull_multicast;
+extern cvar_t *sv_cull_sound_distance;
 extern cvar_t *sv_demo_list;
 extern cvar_t *sv_enforce_time;
 extern cvar_t *sv_hostname;
@@ -41,6 +45,9 @@ extern cvar_t *sv_max_entities;
 extern cvar_t *sv_min_clients;
 extern cvar_t *sv_public;
 extern cvar_t *sv_stats_url;
+extern cvar_t *sv_threads;
+extern cvar_t *sv_trace_bvh;
+extern cvar_t *sv_trace_cache;
 extern cvar_t *sv_timeout;
 
 // per-level and static server structures
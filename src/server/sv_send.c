@@ -176,6 +176,45 @@ void Sv_Unicast(const g_client_t *cl, const bool reliable) {
   Mem_ClearBuffer(&sv.multicast);
 }
 
+/**
+ * @return True if the client is within the specified multicast scope of `origin`.
+ * @details The potentially hearable set includes everything within earshot of the
+ * client, as well as everything potentially visible to it.
+ */
+static bool Sv_MulticastRelevant(const sv_client_t *cl, const vec3_t origin, int32_t cluster, multicast_t scope) {
+
+  if (scope == MULTICAST_ALL || !sv_cull_multicast->integer) {
+    return true;
+  }
+
+  const vec3_t eye = Sv_ClientViewOrigin(cl);
+  const int32_t eye_cluster = Sv_PointCluster(eye);
+
+  if (scope == MULTICAST_PHS) {
+    if (!Cm_ClusterHearable(eye_cluster, cluster)) {
+      return false;
+    }
+  } else {
+    if (!Cm_ClusterVisible(eye_cluster, cluster)) {
+      return false;
+    }
+  }
+
+  const float dist = Vec3_Distance(eye, origin);
+
+  if (scope == MULTICAST_PHS) {
+    if (dist <= sv_cull_sound_distance->value) {
+      return true;
+    }
+  }
+
+  if (dist > sv_cull_distance->value) {
+    return false;
+  }
+
+  return Sv_PointVisible(eye, origin);
+}
+
 /**
  * @brief Sends the contents of `sv.multicast` to a subset of the clients,
  * then clears `sv.multicast`.
@@ -183,24 +222,28 @@ void Sv_Unicast(const g_client_t *cl, const bool reliable) {
 void Sv_Multicast(const vec3_t origin, multicast_t to) {
 
   bool reliable = false;
+  multicast_t scope;
 
   switch (to) {
     case MULTICAST_ALL_R:
       reliable = true;
       __attribute__((fallthrough));
     case MULTICAST_ALL:
+      scope = MULTICAST_ALL;
       break;
 
     case MULTICAST_PHS_R:
       reliable = true;
       __attribute__((fallthrough));
     case MULTICAST_PHS:
+      scope = MULTICAST_PHS;
       break;
 
     case MULTICAST_PVS_R:
       reliable = true;
       __attribute__((fallthrough));
     case MULTICAST_PVS:
+      scope = MULTICAST_PVS;
       break;
 
     default:
@@ -209,6 +252,8 @@ void Sv_Multicast(const vec3_t origin, multicast_t to) {
       return;
   }
 
+  const int32_t cluster = scope == MULTICAST_ALL ? -1 : Sv_PointCluster(origin);
+
   // send the data to all relevant clients
   sv_client_t *cl = svs.clients;
   for (int32_t j = 0; j < sv_max_clients->integer; j++, cl++) {
@@ -229,8 +274,9 @@ void Sv_Multicast(const vec3_t origin, multicast_t to) {
       continue;
     }
 
-    if (to != MULTICAST_ALL && to != MULTICAST_ALL_R) {
-      // TODO: Some basic tracing or just distance attenuation?
+    if (!Sv_MulticastRelevant(cl, origin, cluster, scope)) {
+      sv.stats.multicast_bytes_culled[scope] += sv.multicast.size;
+      continue;
     }
 
     if (reliable) {
@@ -238,44 +284,127 @@ void Sv_Multicast(const vec3_t origin, multicast_t to) {
     } else {
       Sv_ClientDatagramMessage(cl, sv.multicast.data, sv.multicast.size);
     }
+
+    sv.stats.multicast_bytes[scope] += sv.multicast.size;
   }
 
   Mem_ClearBuffer(&sv.multicast);
 }
 
 /**
- * @brief Builds and transmits the current frame packet to the specified client.
+ * @brief Builds and encodes the current frame for the specified client.
+ * @remarks This is called from the client frame worker threads.
  */
-static void Sv_SendClientDatagram(sv_client_t *cl) {
-  byte buffer[MAX_MSG_SIZE];
-  mem_buf_t buf;
+static void Sv_BuildClientDatagram(sv_client_t *cl) {
 
   Sv_BuildClientFrame(cl);
 
-  Mem_InitBuffer(&buf, buffer, sizeof(buffer));
+  Mem_InitBuffer(&cl->frame_message, cl->frame_buffer, sizeof(cl->frame_buffer));
+
+  // write all the relevant entity_state_t and the player_state_t
+  Sv_WriteClientFrame(cl, &cl->frame_message);
+}
+
+/**
+ * @brief The clients whose frames are built in parallel each server frame.
+ */
+typedef struct {
+  /**
+   * @brief The active, non-AI clients.
+   */
+  sv_client_t *clients[MAX_CLIENTS];
+
+  /**
+   * @brief The count of `clients`.
+   */
+  int32_t num_clients;
+
+  /**
+   * @brief The index of the next client to build, shared by all workers.
+   */
+  SDL_AtomicInt next_client;
+} sv_client_frames_t;
+
+/**
+ * @brief Thread entry point: builds client frames until none remain.
+ */
+static void Sv_BuildClientDatagrams_(void *data) {
+
+  sv_client_frames_t *frames = data;
+
+  while (true) {
+    const int32_t i = SDL_AddAtomicInt(&frames->next_client, 1);
+    if (i >= frames->num_clients) {
+      break;
+    }
+
+    Sv_BuildClientDatagram(frames->clients[i]);
+  }
+}
+
+/**
+ * @brief Builds and encodes all client frames, distributing them over `sv_threads`
+ * workers. The main thread participates, and returns once all frames are built.
+ * @return The count of threads that built frames.
+ */
+static int32_t Sv_BuildClientDatagrams(sv_client_frames_t *frames) {
+  thread_t *threads[MAX_THREADS];
+
+  int32_t num_threads = sv_threads->integer ?: Thread_Count() + 1;
+  num_threads = Maxi(1, Mini(num_threads, Mini(Thread_Count() + 1, frames->num_clients)));
+
+  for (int32_t i = 1; i < num_threads; i++) {
+    threads[i] = Thread_Create(Sv_BuildClientDatagrams_, frames, THREAD_NONE);
+  }
 
-  // send over all the relevant entity_state_t and the player_state_t
-  Sv_WriteClientFrame(cl, &buf);
+  Sv_BuildClientDatagrams_(frames);
+
+  for (int32_t i = 1; i < num_threads; i++) {
+    Thread_Wait(threads[i]);
+  }
+
+  // accumulate the per-client counters now that the workers are done
+  for (int32_t i = 0; i < frames->num_clients; i++) {
+    const sv_client_t *cl = frames->clients[i];
+
+    if (cl->gclient->in_use) {
+      sv.stats.client_frames++;
+    }
+
+    sv.stats.frame_entities += cl->frame_entities;
+    sv.stats.frame_entities_culled += cl->frame_entities_culled;
+  }
+
+  return num_threads;
+}
+
+/**
+ * @brief Transmits the current frame, along with any pending datagram messages,
+ * to the specified client.
+ */
+static void Sv_SendClientDatagram(sv_client_t *cl) {
+
+  mem_buf_t *buf = &cl->frame_message;
 
   if (cl->datagram.messages) {
     for (const ListNode *node = cl->datagram.messages->head; node; node = node->next) {
       const sv_client_message_t *msg = (const sv_client_message_t *) node->element;
 
       // if we would overflow the packet, flush it first
-      if (buf.size + msg->len > (MAX_MSG_SIZE_UDP - 16)) {
-        Com_Debug(DEBUG_SERVER, "Fragmenting datagram @ %u bytes\n", (uint32_t) buf.size);
+      if (buf->size + msg->len > (MAX_MSG_SIZE_UDP - 16)) {
+        Com_Debug(DEBUG_SERVER, "Fragmenting datagram @ %u bytes\n", (uint32_t) buf->size);
 
-        Netchan_Transmit(&cl->net_chan, buf.data, buf.size);
+        Netchan_Transmit(&cl->net_chan, buf->data, buf->size);
 
-        Mem_ClearBuffer(&buf);
+        Mem_ClearBuffer(buf);
       }
 
-      Mem_WriteBuffer(&buf, cl->datagram.buffer.data + msg->offset, msg->len);
+      Mem_WriteBuffer(buf, cl->datagram.buffer.data + msg->offset, msg->len);
     }
   }
 
   // send the pending packet, which may include reliable messages
-  Netchan_Transmit(&cl->net_chan, buf.data, buf.size);
+  Netchan_Transmit(&cl->net_chan, buf->data, buf->size);
 }
 
 /**
@@ -319,47 +448,106 @@ static void Sv_DemoCompleted(void) {
 }
 
 /**
- * @brief Reads the next frame from the current demo file into the specified buffer,
- * returning the size of the frame in bytes.
- *
- * FIXME: This doesn't work with the new packetized overflow avoidance. Multiple
- * messages can constitute a frame. We need a mechanism to indicate frame
- * completion, or we need a timecode in our demos.
+ * @brief Reads the next message of the current demo frame into the specified buffer,
+ * returning the size of the message in bytes. Multiple messages can constitute a frame,
+ * so messages are read ahead and delivered once playback reaches their timecode.
+ * @return The size of the message, or 0 once the frame is complete or the demo has ended.
  */
-static size_t Sv_GetDemoMessage(byte *buffer) {
-  int32_t size;
-  int64_t r;
+static size_t Sv_GetDemoMessage(byte *buffer, uint32_t time) {
+
+  if (sv.demo_message_size == 0) {
+    const int32_t size = Demo_ReadMessage(sv.demo_file,
+                                          sv.demo_message,
+                                          sizeof(sv.demo_message),
+                                          &sv.demo_message_time);
+    if (size <= 0) {
+      Sv_DemoCompleted();
+      return 0;
+    }
 
-  r = Fs_Read(sv.demo_file, &size, sizeof(size), 1);
+    sv.demo_message_size = size;
+  }
 
-  if (r != 1) { // improperly terminated demo file
-    Com_Warn("Failed to read demo file\n");
-    Sv_DemoCompleted();
+  if (sv.demo_message_time > time) {
     return 0;
   }
 
-  size = LittleLong(size);
+  const size_t size = sv.demo_message_size;
+  memcpy(buffer, sv.demo_message, size);
 
-  if (size == -1) { // properly terminated demo file
-    Sv_DemoCompleted();
-    return 0;
+  sv.demo_message_size = 0;
+  return size;
+}
+
+/**
+ * @brief Sends all demo messages for the current frame to every connected client. Playback
+ * does not advance until a client is connected.
+ */
+static void Sv_SendDemoPackets(void) {
+
+  bool connected = false;
+
+  const sv_client_t *cl = svs.clients;
+  for (int32_t i = 0; i < sv_max_clients->integer; i++, cl++) {
+    if (cl->state != SV_CLIENT_FREE && !cl->gclient->ai) {
+      connected = true;
+    }
   }
 
-  if (size > MAX_MSG_SIZE) { // corrupt demo file
-    Com_Warn("%d > MAX_MSG_SIZE\n", size);
-    Sv_DemoCompleted();
-    return 0;
+  if (!connected) {
+    return;
+  }
+
+  const uint32_t time = sv.demo_time;
+  sv.demo_time += QUETOO_TICK_MILLIS;
+
+  byte buffer[MAX_MSG_SIZE];
+  size_t size;
+
+  while ((size = Sv_GetDemoMessage(buffer, time))) {
+
+    sv_client_t *cl = svs.clients;
+    for (int32_t i = 0; i < sv_max_clients->integer; i++, cl++) {
+
+      if (cl->state == SV_CLIENT_FREE || cl->gclient->ai) {
+        continue;
+      }
+
+      Netchan_Transmit(&cl->net_chan, buffer, size);
+    }
+  }
+}
+
+/**
+ * @brief Seeks the current demo to the last keyframe at or before `time`, in milliseconds.
+ * Playback resumes from the keyframe's timecode.
+ */
+void Sv_SeekDemo(uint32_t time) {
+
+  if (svs.state != SV_ACTIVE_DEMO || !sv.demo_file) {
+    Com_Print("Not playing a demo\n");
+    return;
   }
 
-  r = Fs_Read(sv.demo_file, buffer, size, 1);
+  if (!Demo_SeekTime(sv.demo_file, time)) {
+    Com_Warn("Failed to seek to %.1fs\n", MILLIS_TO_SECONDS(time));
+    return;
+  }
 
-  if (r != 1) {
-    Com_Warn("Incomplete or corrupt demo file\n");
+  const int32_t size = Demo_ReadMessage(sv.demo_file,
+                                        sv.demo_message,
+                                        sizeof(sv.demo_message),
+                                        &sv.demo_message_time);
+  if (size <= 0) {
+    sv.demo_message_size = 0;
     Sv_DemoCompleted();
-    return 0;
+    return;
   }
 
-  return size;
+  sv.demo_message_size = size;
+  sv.demo_time = sv.demo_message_time;
+
+  Com_Debug(DEBUG_SERVER, "Demo seeked to %.1fs\n", MILLIS_TO_SECONDS(sv.demo_time));
 }
 
 /**
@@ -371,8 +559,33 @@ void Sv_SendClientPackets(void) {
     return;
   }
 
-  // send a message to each connected client
+  if (svs.state == SV_ACTIVE_DEMO) {
+    Sv_SendDemoPackets();
+    return;
+  }
+
+  const uint64_t start = SDL_GetTicksNS();
+
+  // build and encode the game frames for all active clients in parallel
+  sv_client_frames_t frames = { .num_clients = 0 };
+  int32_t num_threads = 0;
+
   sv_client_t *cl = svs.clients;
+  for (int32_t i = 0; i < sv_max_clients->integer; i++, cl++) {
+
+    if (cl->state == SV_CLIENT_ACTIVE && !cl->gclient->ai) {
+      frames.clients[frames.num_clients++] = cl;
+    }
+  }
+
+  if (frames.num_clients) {
+    num_threads = Sv_BuildClientDatagrams(&frames);
+  }
+
+  const uint64_t built = SDL_GetTicksNS();
+
+  // then send a message to each connected client, in order
+  cl = svs.clients;
   for (int32_t i = 0; i < sv_max_clients->integer; i++, cl++) {
 
     if (cl->state == SV_CLIENT_FREE) {
@@ -383,16 +596,7 @@ void Sv_SendClientPackets(void) {
       continue;
     }
 
-    if (svs.state == SV_ACTIVE_DEMO) { // send the demo packet
-      byte buffer[MAX_MSG_SIZE];
-      size_t size;
-
-      if ((size = Sv_GetDemoMessage(buffer))) {
-        Netchan_Transmit(&cl->net_chan, buffer, size);
-      } else {
-        break;    // recording is done, so we're done
-      }
-    } else if (cl->state == SV_CLIENT_ACTIVE) { // send the game packet
+    if (cl->state == SV_CLIENT_ACTIVE) { // send the game packet
 
       Sv_SendClientDatagram(cl);
 
@@ -407,4 +611,20 @@ void Sv_SendClientPackets(void) {
       Netchan_Transmit(&cl->net_chan, NULL, 0);
     }
   }
+
+  const uint64_t sent = SDL_GetTicksNS();
+
+  if (frames.num_clients) {
+    sv.stats.send_frames++;
+    sv.stats.frame_build_nanos += built - start;
+    sv.stats.frame_transmit_nanos += sent - built;
+
+    if (sv.frame_num % QUETOO_TICK_RATE == 0) {
+      Com_Debug(DEBUG_SERVER, "Client frames: %d clients on %d threads, built in %.2fms, sent in %.2fms\n",
+                frames.num_clients,
+                num_threads,
+                (built - start) / 1000000.0,
+                (sent - built) / 1000000.0);
+    }
+  }
 }
@@ -25,6 +25,7 @@
 
 #if defined(__SV_LOCAL_H__)
 void Sv_SendClientPackets(void);
+void Sv_SeekDemo(uint32_t time);
 void Sv_Unicast(const g_client_t *cl, const bool reliable);
 void Sv_Multicast(const vec3_t origin, multicast_t to);
 void Sv_ClientPrint(const g_client_t *cl, int32_t level, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
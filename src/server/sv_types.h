@@ -38,10 +38,16 @@ typedef enum {
 
 #if defined(__SV_LOCAL_H__)
 
+/**
+ * @brief The maximum number of visibility clusters an entity may occupy before it is
+ * considered potentially visible from everywhere.
+ */
+#define SV_MAX_ENT_CLUSTERS 16
+
 /**
  * @brief The server entity type.
  */
-typedef struct {
+typedef struct sv_entity_s {
 
   /**
    * @brief The corresponding game entity; set once per map at spawn time.
@@ -54,9 +60,29 @@ typedef struct {
   entity_state_t baseline;
 
   /**
-   * @brief World sector for entity list management.
+   * @brief The world octree node the entity is linked to, or `NULL`.
+   */
+  struct sv_world_node_s *world_node;
+
+  /**
+   * @brief The previous entity linked to the same world node.
+   */
+  struct sv_entity_s *world_prev;
+
+  /**
+   * @brief The next entity linked to the same world node.
+   */
+  struct sv_entity_s *world_next;
+
+  /**
+   * @brief The visibility clusters the entity occupies.
    */
-  struct sv_sector_s *sector;
+  int32_t clusters[SV_MAX_ENT_CLUSTERS];
+
+  /**
+   * @brief The count of clusters, 0 if unknown, or -1 if the entity occupies too many.
+   */
+  int32_t num_clusters;
 
   /**
    * @brief World-space transform for collision tests.
@@ -69,6 +95,93 @@ typedef struct {
   mat4_t inverse_matrix;
 } sv_entity_t;
 
+/**
+ * @brief The count of unique multicast scopes, ignoring reliability.
+ */
+#define SV_MULTICAST_SCOPES (MULTICAST_PVS + 1)
+
+/**
+ * @brief Server performance counters, accumulated over the current level and
+ * reported by the `server_stats` command.
+ */
+typedef struct {
+
+  /**
+   * @brief The count of client frames built.
+   */
+  uint32_t client_frames;
+
+  /**
+   * @brief The count of entities considered for inclusion in client frames.
+   */
+  uint64_t frame_entities;
+
+  /**
+   * @brief The count of entities culled from client frames as irrelevant.
+   */
+  uint64_t frame_entities_culled;
+
+  /**
+   * @brief The bytes of multicast data delivered to clients, by scope.
+   */
+  uint64_t multicast_bytes[SV_MULTICAST_SCOPES];
+
+  /**
+   * @brief The bytes of multicast data withheld from clients outside of the scope.
+   */
+  uint64_t multicast_bytes_culled[SV_MULTICAST_SCOPES];
+
+  /**
+   * @brief The count of server frames in which client packets were sent.
+   */
+  uint32_t send_frames;
+
+  /**
+   * @brief The time spent building and encoding client frames, in nanoseconds.
+   */
+  uint64_t frame_build_nanos;
+
+  /**
+   * @brief The time spent packetizing and transmitting client frames, in nanoseconds.
+   */
+  uint64_t frame_transmit_nanos;
+
+  /**
+   * @brief The count of `Sv_BoxEntities` queries, which back all traces and contents tests.
+   */
+  uint64_t box_queries;
+
+  /**
+   * @brief The count of world octree nodes visited by queries.
+   */
+  uint64_t box_nodes;
+
+  /**
+   * @brief The count of entities tested against query bounds.
+   */
+  uint64_t box_entities_tested;
+
+  /**
+   * @brief The count of entities returned by queries.
+   */
+  uint64_t box_entities_found;
+
+  /**
+   * @brief The count of `Sv_Trace` queries.
+   */
+  uint64_t trace_queries;
+
+  /**
+   * @brief The count of `Sv_Trace` queries answered by the trace cache.
+   */
+  uint64_t trace_cache_hits;
+
+  /**
+   * @brief The count of trace cache invalidations, caused by entity links.
+   */
+  uint64_t trace_cache_invalidations;
+} sv_stats_t;
+
 /**
  * @brief The `sv_server_t` struct is wiped at each level load.
  */
@@ -117,7 +230,32 @@ typedef struct {
   /**
    * @brief Open demo file for demo playback, or `NULL` during live gameplay.
    */
-  file_t *demo_file;
+  demo_t *demo_file;
+
+  /**
+   * @brief The demo playback time, in milliseconds.
+   */
+  uint32_t demo_time;
+
+  /**
+   * @brief The next demo message, read ahead until its timecode is reached.
+   */
+  byte demo_message[MAX_MSG_SIZE];
+
+  /**
+   * @brief The size of `demo_message`, or 0 if the next message has not been read.
+   */
+  size_t demo_message_size;
+
+  /**
+   * @brief The timecode of `demo_message`, in milliseconds.
+   */
+  uint32_t demo_message_time;
+
+  /**
+   * @brief Performance counters for the current level.
+   */
+  sv_stats_t stats;
 } sv_server_t;
 
 /**
@@ -298,6 +436,34 @@ typedef struct {
    */
   sv_client_frame_t frames[PACKET_BACKUP];
 
+  /**
+   * @brief The encoded frame for the current server frame. Built in parallel with
+   * other clients' frames, and then transmitted along with `datagram` on the main thread.
+   */
+  mem_buf_t frame_message;
+
+  /**
+   * @brief Backing storage for `frame_message`.
+   */
+  byte frame_buffer[MAX_MSG_SIZE];
+
+  /**
+   * @brief Entities considered and culled for the current frame, accumulated
+   * into `sv.stats` once all client frames are built.
+   */
+  uint32_t frame_entities, frame_entities_culled;
+
+  /**
+   * @brief Scratch list of the entities relevant to the current frame.
+   */
+  uint16_t frame_entity_numbers[MAX_ENTITIES];
+
+  /**
+   * @brief Server time until which each entity is considered visible to this client,
+   * so that `sv_cull_entities 2` need not re-test visible entities every frame.
+   */
+  uint32_t entity_visible_time[MAX_ENTITIES];
+
   /**
    * @brief HTTP file download connection for this client.
    */
@@ -397,9 +563,10 @@ typedef struct {
   uint32_t num_entity_states;
 
   /**
-   * @brief Next free index in `entity_states` for newly spawned entities.
+   * @brief Next free index in `entity_states`. Client frames reserve contiguous slices
+   * of the ring from this cursor, possibly from several threads at once.
    */
-  uint32_t next_entity_state;
+  SDL_AtomicU32 next_entity_state;
 
   /**
    * @brief The configured master server, and its outstanding challenge.
@@ -21,86 +21,208 @@
 
 #include "sv_local.h"
 
-// FIXME: Couldn't we use the BSP blocks for this now?
+/**
+ * @brief The world is partitioned by a loose octree to aid in entity management.
+ * Each node's bounds are twice the size of its cell, so that an entity is linked
+ * to exactly one node: the deepest whose cell contains the entity's center and
+ * whose cell is at least as large as the entity. Entities are linked to nodes
+ * intrusively, and each node counts the entities beneath it, so that queries
+ * only descend into occupied space.
+ */
+typedef struct sv_world_node_s {
+  /**
+   * @brief The loose bounds of the node, enclosing any entity linked to it.
+   */
+  box3_t bounds;
+
+  /**
+   * @brief The parent node, or `NULL` for the root.
+   */
+  struct sv_world_node_s *parent;
+
+  /**
+   * @brief The eight child nodes, or `NULL` for leafs.
+   */
+  struct sv_world_node_s *children;
+
+  /**
+   * @brief The entities linked to this node.
+   */
+  sv_entity_t *entities;
+
+  /**
+   * @brief The count of entities linked to this node and its descendants.
+   */
+  int32_t num_entities;
+} sv_world_node_t;
+
+/**
+ * @brief The depth of the octree. Leaf cells of a 4096 unit map are 128 units.
+ */
+#define SV_WORLD_DEPTH 5
+
+/**
+ * @brief The count of nodes in a complete octree of `SV_WORLD_DEPTH`.
+ */
+#define SV_WORLD_NODES (((1 << (3 * (SV_WORLD_DEPTH + 1))) - 1) / 7)
 
 /**
- * @brief The world is divided into evenly sized sectors to aid in entity
- * management. This works like a meta-BSP tree, providing fast searches via
- * recursion to find entities within an arbitrary box.
+ * @brief The count of trace cache entries. Must be a power of two.
  */
-typedef struct sv_sector_s {
-  int32_t axis; // -1 = leaf
-  float dist;
-  struct sv_sector_s *children[2];
-  List *entities;
-} sv_sector_t;
+#define SV_TRACE_CACHE_SIZE 1024
 
-#define SECTOR_DEPTH  4
-#define SECTOR_NODES  32
+/**
+ * @brief A memoized trace. Entries are valid only within the frame and generation
+ * in which they were traced.
+ */
+typedef struct {
+  /**
+   * @brief The trace parameters.
+   */
+  vec3_t start, end;
+  box3_t bounds;
+  const g_entity_t *skip;
+  int32_t contents;
+
+  /**
+   * @brief The skip entity's owner and solid, which the skip rules depend on.
+   */
+  const g_entity_t *skip_owner;
+  solid_t skip_solid;
+
+  /**
+   * @brief The server frame and cache generation in which the trace was resolved.
+   */
+  uint32_t frame_num, generation;
+
+  /**
+   * @brief The trace result.
+   */
+  cm_trace_t trace;
+} sv_trace_cache_entry_t;
 
 /**
- * @brief The world structure contains all sectors and also the current query
- * context issued to `Sv_BoxEntities`.
+ * @brief The world structure contains all octree nodes.
  */
 typedef struct {
-  sv_sector_t sectors[SECTOR_NODES];
-  size_t num_sectors;
+  /**
+   * @brief The octree nodes, in which `nodes[0]` is the root.
+   */
+  sv_world_node_t *nodes;
 
-  box3_t box;
+  /**
+   * @brief The count of allocated nodes.
+   */
+  size_t num_nodes;
 
-  g_entity_t **box_entities;
-  size_t num_box_entities, max_box_entities;
+  /**
+   * @brief The trace cache, a direct-mapped table of memoized traces.
+   */
+  sv_trace_cache_entry_t *trace_cache;
 
-  uint32_t box_type; // BOX_SOLID, BOX_TRIGGER, ..
+  /**
+   * @brief The trace cache generation, incremented whenever a collidable entity is linked,
+   * moved or unlinked. Entries from prior generations are stale.
+   */
+  uint32_t trace_cache_generation;
 } sv_world_t;
 
 static sv_world_t sv_world;
 
 /**
- * @brief Builds a uniformly subdivided tree for the given world size.
+ * @brief A query issued to `Sv_BoxEntities`. Queries are kept on the stack so that
+ * they may be issued reentrantly.
  */
-static sv_sector_t *Sv_CreateSector(int32_t depth, const box3_t bounds) {
-  sv_sector_t *sector = &sv_world.sectors[sv_world.num_sectors];
-  sv_world.num_sectors++;
+typedef struct {
+  /**
+   * @brief The query bounds.
+   */
+  box3_t bounds;
 
-  if (depth == SECTOR_DEPTH) {
-    sector->axis = -1;
-    sector->children[0] = sector->children[1] = NULL;
-    return sector;
-  }
+  /**
+   * @brief The query type, e.g. `BOX_COLLIDE`.
+   */
+  uint32_t type;
 
-  vec3_t size = Box3_Size(bounds);
+  /**
+   * @brief The output array.
+   */
+  g_entity_t **entities;
 
-  if (size.x > size.y) {
-    sector->axis = 0;
-  } else {
-    sector->axis = 1;
+  /**
+   * @brief The count of entities found, and the capacity of `entities`.
+   */
+  size_t num_entities, max_entities;
+
+  /**
+   * @brief The count of nodes visited and entities tested, for `sv_stats_t`.
+   */
+  size_t num_nodes, num_tested;
+} sv_box_query_t;
+
+/**
+ * @brief Recursively builds a complete loose octree beneath the given node.
+ * @param cell The node's cell, which its loose bounds enclose by half of its size.
+ */
+static void Sv_CreateWorldNode(sv_world_node_t *node, const box3_t cell, int32_t depth) {
+
+  node->bounds = Box3_Expand3(cell, Vec3_Scale(Box3_Size(cell), .5f));
+
+  if (depth == SV_WORLD_DEPTH) {
+    return;
   }
 
-  sector->dist = 0.5f * (bounds.maxs.xyz[sector->axis] + bounds.mins.xyz[sector->axis]);
+  node->children = &sv_world.nodes[sv_world.num_nodes];
+  sv_world.num_nodes += 8;
 
-  box3_t bounds1 = bounds, bounds2 = bounds;
+  const vec3_t center = Box3_Center(cell);
 
-  bounds1.maxs.xyz[sector->axis] = bounds2.mins.xyz[sector->axis] = sector->dist;
+  for (int32_t i = 0; i < 8; i++) {
+    box3_t child_cell = cell;
 
-  sector->children[0] = Sv_CreateSector(depth + 1, bounds2);
-  sector->children[1] = Sv_CreateSector(depth + 1, bounds1);
+    for (int32_t j = 0; j < 3; j++) {
+      if (i & (1 << j)) {
+        child_cell.mins.xyz[j] = center.xyz[j];
+      } else {
+        child_cell.maxs.xyz[j] = center.xyz[j];
+      }
+    }
 
-  return sector;
+    node->children[i].parent = node;
+    Sv_CreateWorldNode(&node->children[i], child_cell, depth + 1);
+  }
 }
 
 /**
- * @brief Initializes the world sector tree for spatial partitioning of entities.
+ * @brief Initializes the world octree for spatial partitioning of entities. The root
+ * cell is the cube enclosing the world model.
  */
 static void Sv_InitWorld(void) {
 
-  for (size_t i = 0; i < sv_world.num_sectors; i++) {
-    sv_world.sectors[i].entities = release(sv_world.sectors[i].entities);
+  if (sv_world.nodes) {
+    Mem_Free(sv_world.nodes);
+  }
+
+  if (sv_world.trace_cache) {
+    Mem_Free(sv_world.trace_cache);
   }
 
   memset(&sv_world, 0, sizeof(sv_world));
 
-  Sv_CreateSector(0, sv.cm_models[0]->bounds);
+  sv_world.nodes = Mem_TagMalloc(sizeof(sv_world_node_t) * SV_WORLD_NODES, MEM_TAG_SERVER);
+  sv_world.num_nodes = 1;
+
+  sv_world.trace_cache = Mem_TagMalloc(sizeof(sv_trace_cache_entry_t) * SV_TRACE_CACHE_SIZE, MEM_TAG_SERVER);
+  sv_world.trace_cache_generation = 1;
+
+  const box3_t bounds = sv.cm_models[0]->bounds;
+  const float size = Vec3_Hmaxf(Box3_Size(bounds));
+
+  const box3_t cell = Box3_FromCenterSize(Box3_Center(bounds), Vec3(size, size, size));
+
+  Sv_CreateWorldNode(sv_world.nodes, cell, 0);
+
+  assert(sv_world.num_nodes == SV_WORLD_NODES);
 }
 
 /**
@@ -152,22 +274,36 @@ void Sv_SpawnEntities(const char *name, const cm_entity_t *props) {
 }
 
 /**
- * @brief Called before moving or freeing an entity to remove it from the clipping
- * hull.
+ * @brief Invalidates all memoized traces.
  */
-void Sv_UnlinkEntity(g_entity_t *ent) {
+static void Sv_InvalidateTraceCache(void) {
+
+  sv_world.trace_cache_generation++;
+  sv.stats.trace_cache_invalidations++;
+}
+
+/**
+ * @brief Removes the entity from its octree node.
+ */
+static void Sv_UnlinkEntity_(g_entity_t *ent) {
 
   sv_entity_t *sent = &sv.entities[ent->s.number];
 
-  if (sent->sector) {
-    sv_sector_t *sector = (sv_sector_t *) sent->sector;
-    if (sector->entities) {
-      for (ListNode *node = sector->entities->head; node; node = node->next) {
-        if (node->element == ent) {
-          $(sector->entities, removeNode, node);
-          break;
-        }
-      }
+  if (sent->world_node) {
+    sv_world_node_t *node = sent->world_node;
+
+    if (sent->world_prev) {
+      sent->world_prev->world_next = sent->world_next;
+    } else {
+      node->entities = sent->world_next;
+    }
+
+    if (sent->world_next) {
+      sent->world_next->world_prev = sent->world_prev;
+    }
+
+    for (; node; node = node->parent) {
+      node->num_entities--;
     }
 
     g_entity_t *gent = sent->gent;
@@ -176,16 +312,91 @@ void Sv_UnlinkEntity(g_entity_t *ent) {
   }
 }
 
+/**
+ * @brief Called before moving or freeing an entity to remove it from the clipping
+ * hull.
+ */
+void Sv_UnlinkEntity(g_entity_t *ent) {
+
+  if (sv.entities[ent->s.number].world_node) {
+    Sv_InvalidateTraceCache();
+  }
+
+  Sv_UnlinkEntity_(ent);
+}
+
+/**
+ * @brief The maximum number of leafs resolved when linking an entity's clusters.
+ */
+#define SV_MAX_ENT_LEAFS 128
+
+/**
+ * @brief Resolves the visibility clusters the entity occupies, for PVS and PHS culling.
+ */
+static void Sv_LinkEntityClusters(sv_entity_t *sent, const g_entity_t *ent) {
+
+  sent->num_clusters = 0;
+
+  if (!Cm_NumClusters()) {
+    return;
+  }
+
+  int32_t leafs[SV_MAX_ENT_LEAFS];
+  const size_t num_leafs = Cm_BoxLeafnums(ent->abs_bounds, leafs, lengthof(leafs), NULL, 0);
+
+  if (num_leafs == lengthof(leafs)) {
+    sent->num_clusters = -1;
+    return;
+  }
+
+  for (size_t i = 0; i < num_leafs; i++) {
+
+    const int32_t cluster = Cm_LeafCluster(leafs[i]);
+    if (cluster == -1) {
+      continue;
+    }
+
+    int32_t j;
+    for (j = 0; j < sent->num_clusters; j++) {
+      if (sent->clusters[j] == cluster) {
+        break;
+      }
+    }
+
+    if (j < sent->num_clusters) {
+      continue;
+    }
+
+    if (sent->num_clusters == SV_MAX_ENT_CLUSTERS) {
+      sent->num_clusters = -1;
+      return;
+    }
+
+    sent->clusters[sent->num_clusters++] = cluster;
+  }
+}
+
 /**
  * @brief Called whenever an entity changes origin, mins, maxs, or solid to add it to
  * the clipping hull.
  */
 void Sv_LinkEntity(g_entity_t *ent) {
 
-  // remove it from its current sector
-  Sv_UnlinkEntity(ent);
+  sv_entity_t *sent = &sv.entities[ent->s.number];
+
+  // note where it was linked, to determine whether memoized traces are affected
+  const bool was_linked = sent->world_node != NULL;
+  const solid_t was_solid = ent->s.solid;
+  const box3_t was_abs_bounds = ent->abs_bounds;
+  const mat4_t was_matrix = sent->matrix;
+
+  // remove it from its current node
+  Sv_UnlinkEntity_(ent);
 
   if (!ent->in_use) { // and if its free, we're done
+    if (was_linked) {
+      Sv_InvalidateTraceCache();
+    }
     return;
   }
 
@@ -209,50 +420,72 @@ void Sv_LinkEntity(g_entity_t *ent) {
 
   const vec3_t angles = ent->solid == SOLID_BSP ? ent->s.angles : Vec3_Zero();
 
-  sv_entity_t *sent = &sv.entities[ent->s.number];
-
   sent->matrix = Mat4_FromRotationTranslationScale(angles, ent->s.origin, 1.f);
   sent->inverse_matrix = Mat4_Inverse(sent->matrix);
   ent->abs_bounds = Cm_EntityBounds(ent->solid, sent->matrix, ent->bounds);
 
+  Sv_LinkEntityClusters(sent, ent);
+
   if (ent->solid == SOLID_NOT) {
+    if (was_linked) {
+      Sv_InvalidateTraceCache();
+    }
     return;
   }
 
-  // find the first sector that the ent's box crosses
-  sv_sector_t *sector = sv_world.sectors;
-  while (true) {
+  if (!was_linked ||
+      was_solid != ent->solid ||
+      memcmp(&was_abs_bounds, &ent->abs_bounds, sizeof(box3_t)) ||
+      memcmp(&was_matrix, &sent->matrix, sizeof(mat4_t))) {
+    Sv_InvalidateTraceCache();
+  }
+
+  // find the deepest node that encloses the entity, following its center
+  sv_world_node_t *node = sv_world.nodes;
+  while (node->children) {
 
-    if (sector->axis == -1) {
-      break;
+    const vec3_t center = Box3_Center(node->bounds);
+    const vec3_t origin = Box3_Center(ent->abs_bounds);
+
+    int32_t i = 0;
+    for (int32_t j = 0; j < 3; j++) {
+      if (origin.xyz[j] > center.xyz[j]) {
+        i |= (1 << j);
+      }
     }
 
-    if (ent->abs_bounds.mins.xyz[sector->axis] > sector->dist) {
-      sector = sector->children[0];
-    } else if (ent->abs_bounds.maxs.xyz[sector->axis] < sector->dist) {
-      sector = sector->children[1];
-    } else {
-      break; // crosses the node
+    if (!Box3_Contains(node->children[i].bounds, ent->abs_bounds)) {
+      break;
     }
+
+    node = &node->children[i];
+  }
+
+  // and link it to the node
+  sent->world_node = node;
+  sent->world_prev = NULL;
+  sent->world_next = node->entities;
+
+  if (node->entities) {
+    node->entities->world_prev = sent;
   }
 
-  // add it to the sector
-  sent->sector = sector;
-  if (!sector->entities) {
-    sector->entities = $(alloc(List), init);
+  node->entities = sent;
+
+  for (; node; node = node->parent) {
+    node->num_entities++;
   }
-  $(sector->entities, prepend, ent);
 }
 
 /**
- * @return True if the entity matches the current world filter, false otherwise.
+ * @return True if the entity matches the query type, false otherwise.
  */
-static bool Sv_BoxEntities_Filter(const g_entity_t *ent) {
+static bool Sv_BoxEntities_Filter(const g_entity_t *ent, uint32_t type) {
 
   switch (ent->solid) {
     case SOLID_TRIGGER:
     case SOLID_PROJECTILE:
-      if (sv_world.box_type & BOX_OCCUPY) {
+      if (type & BOX_OCCUPY) {
         return true;
       }
       break;
@@ -260,7 +493,7 @@ static bool Sv_BoxEntities_Filter(const g_entity_t *ent) {
     case SOLID_DEAD:
     case SOLID_BOX:
     case SOLID_BSP:
-      if (sv_world.box_type & BOX_COLLIDE) {
+      if (type & BOX_COLLIDE) {
         return true;
       }
       break;
@@ -274,41 +507,47 @@ static bool Sv_BoxEntities_Filter(const g_entity_t *ent) {
 }
 
 /**
- * @brief Recursively collects entities from the sector tree that overlap the query box.
+ * @brief Recursively collects entities from the octree that overlap the query bounds,
+ * descending only into occupied nodes.
  */
-static void Sv_BoxEntities_r(sv_sector_t *sector) {
+static void Sv_BoxEntities_r(const sv_world_node_t *node, sv_box_query_t *query) {
+
+  query->num_nodes++;
+
+  for (const sv_entity_t *sent = node->entities; sent; sent = sent->world_next) {
+    g_entity_t *ent = sent->gent;
 
-  if (sector->entities) {
-    for (const ListNode *node = sector->entities->head; node; node = node->next) {
-      g_entity_t *ent = (g_entity_t *) node->element;
+    query->num_tested++;
 
-      if (Sv_BoxEntities_Filter(ent)) {
+    if (Sv_BoxEntities_Filter(ent, query->type)) {
 
-        if (Box3_Intersects(ent->abs_bounds, sv_world.box)) {
+      if (Box3_Intersects(ent->abs_bounds, query->bounds)) {
 
-          sv_world.box_entities[sv_world.num_box_entities] = ent;
-          sv_world.num_box_entities++;
+        query->entities[query->num_entities] = ent;
+        query->num_entities++;
 
-          if (sv_world.num_box_entities == sv_world.max_box_entities) {
-            Com_Warn("sv_world.max_box_entities\n");
-            return;
-          }
+        if (query->num_entities == query->max_entities) {
+          Com_Warn("Query exceeds %zu entities\n", query->max_entities);
+          return;
         }
       }
     }
   }
 
-  if (sector->axis == -1) {
+  if (node->children == NULL) {
     return; // terminal node
   }
 
-  // recurse down both sides
-  if (sv_world.box.maxs.xyz[sector->axis] > sector->dist) {
-    Sv_BoxEntities_r(sector->children[0]);
-  }
+  for (int32_t i = 0; i < 8; i++) {
+    const sv_world_node_t *child = &node->children[i];
+
+    if (child->num_entities && Box3_Intersects(child->bounds, query->bounds)) {
+      Sv_BoxEntities_r(child, query);
 
-  if (sv_world.box.mins.xyz[sector->axis] < sector->dist) {
-    Sv_BoxEntities_r(sector->children[1]);
+      if (query->num_entities == query->max_entities) {
+        return;
+      }
+    }
   }
 }
 
@@ -321,18 +560,26 @@ static void Sv_BoxEntities_r(sv_sector_t *sector) {
  */
 size_t Sv_BoxEntities(const box3_t bounds, g_entity_t **list, const size_t len, uint32_t type) {
 
-  sv_world.box = bounds;
-  sv_world.box_entities = list;
-  sv_world.num_box_entities = 0;
-  sv_world.max_box_entities = len;
-  sv_world.box_type = type;
+  if (!sv_world.nodes || !sv_world.nodes->num_entities || !len) {
+    return 0;
+  }
 
-  Sv_BoxEntities_r(sv_world.sectors);
+  sv_box_query_t query = {
+    .bounds = bounds,
+    .type = type,
+    .entities = list,
+    .max_entities = len,
+  };
 
-  sv_world.box = Box3_Zero();
-  sv_world.box_entities = NULL;
+  // the root is always searched, as it holds any entities which exceed the world bounds
+  Sv_BoxEntities_r(sv_world.nodes, &query);
 
-  return sv_world.num_box_entities;
+  sv.stats.box_queries++;
+  sv.stats.box_nodes += query.num_nodes;
+  sv.stats.box_entities_tested += query.num_tested;
+  sv.stats.box_entities_found += query.num_entities;
+
+  return query.num_entities;
 }
 
 /**
@@ -437,40 +684,55 @@ typedef struct {
 } sv_trace_t;
 
 /**
- * @brief Clips the specified trace to the specified entity.
+ * @brief The skipped entity, and entities owned by it, are explicitly not clipped to.
+ * This prevents players from clipping against their own projectiles, etc.
+ *
+ * @return True if the trace ignoring `skip` should not clip to `ent`.
  */
-static void Sv_ClipTraceToEntity(sv_trace_t *trace, const g_entity_t *ent) {
+static bool Sv_SkipTraceEntity(const g_entity_t *skip, const g_entity_t *ent) {
 
-  if (trace->skip) { // see if we can skip it
+  if (skip) { // see if we can skip it
 
-    if (ent == trace->skip) {
-      return; // explicitly (ourselves)
+    if (ent == skip) {
+      return true; // explicitly (ourselves)
     }
 
-    if (ent->owner == trace->skip) {
-      return; // or via ownership (we own it)
+    if (ent->owner == skip) {
+      return true; // or via ownership (we own it)
     }
 
-    if (trace->skip->owner) {
+    if (skip->owner) {
 
-      if (ent == trace->skip->owner) {
-        return; // which is bidirectional (inverse of previous case)
+      if (ent == skip->owner) {
+        return true; // which is bidirectional (inverse of previous case)
       }
 
-      if (ent->owner == trace->skip->owner) {
-        return; // and commutative (we are both owned by the same)
+      if (ent->owner == skip->owner) {
+        return true; // and commutative (we are both owned by the same)
       }
     }
 
     // triggers only clip to the world (while other entities can occupy triggers)
-    if (trace->skip->solid == SOLID_TRIGGER) {
+    if (skip->solid == SOLID_TRIGGER) {
 
       if (ent->solid != SOLID_BSP) {
-        return;
+        return true;
       }
     }
   }
 
+  return false;
+}
+
+/**
+ * @brief Clips the specified trace to the specified entity.
+ */
+static void Sv_ClipTraceToEntity(sv_trace_t *trace, const g_entity_t *ent) {
+
+  if (Sv_SkipTraceEntity(trace->skip, ent)) {
+    return;
+  }
+
   const int32_t head_node = Sv_HullForEntity(ent);
   if (head_node == -1) {
     return;
@@ -511,15 +773,71 @@ static void Sv_ClipTraceToEntities(sv_trace_t *trace) {
   }
 }
 
+/**
+ * @brief The precision to which trace coordinates are quantized for hashing.
+ */
+#define SV_TRACE_CACHE_QUANTIZE 8.f
+
+/**
+ * @return The trace cache entry for the specified trace parameters.
+ * @remarks The coordinates are quantized for hashing only; cache hits require the
+ * parameters to match exactly, so memoized traces are identical to traced ones.
+ */
+static sv_trace_cache_entry_t *Sv_TraceCacheEntry(const vec3_t start, const vec3_t end, const box3_t bounds,
+                                                  const g_entity_t *skip, int32_t contents) {
+
+  const float values[] = {
+    start.x, start.y, start.z,
+    end.x, end.y, end.z,
+    bounds.mins.x, bounds.mins.y, bounds.mins.z,
+    bounds.maxs.x, bounds.maxs.y, bounds.maxs.z
+  };
+
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < lengthof(values); i++) {
+    hash = (hash ^ (uint32_t) (int32_t) floorf(values[i] * SV_TRACE_CACHE_QUANTIZE)) * 16777619u;
+  }
+
+  hash = (hash ^ (uint32_t) contents) * 16777619u;
+  hash = (hash ^ (uint32_t) (skip ? skip->s.number : -1)) * 16777619u;
+
+  return &sv_world.trace_cache[hash & (SV_TRACE_CACHE_SIZE - 1)];
+}
+
 /**
  * @brief Moves the given box volume through the world from start to end.
  *
  * The skipped edict, and edicts owned by him, are explicitly not checked.
  * This prevents players from clipping against their own projectiles, etc.
+ *
+ * With `sv_trace_cache`, identical traces issued within a frame are memoized until
+ * a collidable entity is linked, moved or unlinked.
  */
 cm_trace_t Sv_Trace(const vec3_t start, const vec3_t end, const box3_t bounds,
                     const g_entity_t *skip, int32_t contents) {
 
+  sv.stats.trace_queries++;
+
+  sv_trace_cache_entry_t *entry = NULL;
+
+  if (sv_trace_cache->integer) {
+    entry = Sv_TraceCacheEntry(start, end, bounds, skip, contents);
+
+    if (entry->frame_num == sv.frame_num &&
+        entry->generation == sv_world.trace_cache_generation &&
+        entry->skip == skip &&
+        entry->contents == contents &&
+        !memcmp(&entry->start, &start, sizeof(start)) &&
+        !memcmp(&entry->end, &end, sizeof(end)) &&
+        !memcmp(&entry->bounds, &bounds, sizeof(bounds)) &&
+        entry->skip_owner == (skip ? skip->owner : NULL) &&
+        entry->skip_solid == (skip ? skip->solid : SOLID_NOT)) {
+
+      sv.stats.trace_cache_hits++;
+      return entry->trace;
+    }
+  }
+
   sv_trace_t trace = {
     .start = start,
     .end = end,
@@ -535,9 +853,111 @@ cm_trace_t Sv_Trace(const vec3_t start, const vec3_t end, const box3_t bounds,
 
   Sv_ClipTraceToEntities(&trace);
 
+  if (entry) {
+    *entry = (sv_trace_cache_entry_t) {
+      .start = start,
+      .end = end,
+      .bounds = bounds,
+      .skip = skip,
+      .contents = contents,
+      .skip_owner = skip ? skip->owner : NULL,
+      .skip_solid = skip ? skip->solid : SOLID_NOT,
+      .frame_num = sv.frame_num,
+      .generation = sv_world.trace_cache_generation,
+      .trace = trace.trace
+    };
+  }
+
   return trace.trace;
 }
 
+/**
+ * @brief Moves a batch of box volumes through the world, as if by `count` calls to `Sv_Trace`.
+ * The entities occupying the batch are gathered once, and each entity is then clipped to
+ * every trace that overlaps it with a single `Cm_BoxTraceBatch`.
+ */
+void Sv_TraceBatch(const vec3_t *start, const vec3_t *end, size_t count, const box3_t bounds,
+                   const g_entity_t *skip, int32_t contents, cm_trace_t *traces) {
+
+  while (count > MAX_TRACE_BATCH) {
+    Sv_TraceBatch(start, end, MAX_TRACE_BATCH, bounds, skip, contents, traces);
+
+    start += MAX_TRACE_BATCH;
+    end += MAX_TRACE_BATCH;
+    traces += MAX_TRACE_BATCH;
+    count -= MAX_TRACE_BATCH;
+  }
+
+  if (count == 0) {
+    return;
+  }
+
+  box3_t abs_bounds[MAX_TRACE_BATCH];
+  box3_t batch_bounds = Box3_Null();
+
+  for (size_t i = 0; i < count; i++) {
+    abs_bounds[i] = Cm_TraceBounds(start[i], end[i], bounds);
+    batch_bounds = Box3_Union(batch_bounds, abs_bounds[i]);
+
+    traces[i] = (cm_trace_t) {
+      .fraction = 1.f,
+      .end = end[i]
+    };
+  }
+
+  g_entity_t *e[MAX_ENTITIES];
+  const size_t len = Sv_BoxEntities(batch_bounds, e, lengthof(e), BOX_COLLIDE);
+
+  for (size_t i = 0; i < len; i++) {
+    const g_entity_t *ent = e[i];
+
+    if (Sv_SkipTraceEntity(skip, ent)) {
+      continue;
+    }
+
+    const int32_t head_node = Sv_HullForEntity(ent);
+    if (head_node == -1) {
+      continue;
+    }
+
+    vec3_t s[MAX_TRACE_BATCH], f[MAX_TRACE_BATCH];
+    size_t indexes[MAX_TRACE_BATCH], num_indexes = 0;
+
+    for (size_t j = 0; j < count; j++) {
+      if (Box3_Intersects(ent->abs_bounds, abs_bounds[j])) {
+        s[num_indexes] = start[j];
+        f[num_indexes] = end[j];
+        indexes[num_indexes] = j;
+        num_indexes++;
+      }
+    }
+
+    if (num_indexes == 0) {
+      continue;
+    }
+
+    const sv_entity_t *sent = &sv.entities[ent->s.number];
+
+    cm_trace_t tr[MAX_TRACE_BATCH];
+
+    if (Mat4_Equal(sent->matrix, Mat4_Identity())) {
+      Cm_BoxTraceBatch(s, f, num_indexes, bounds, head_node, contents, tr);
+    } else {
+      Cm_TransformedBoxTraceBatch(s, f, num_indexes, bounds, head_node, contents, sent->matrix, sent->inverse_matrix, tr);
+    }
+
+    for (size_t j = 0; j < num_indexes; j++) {
+      cm_trace_t *trace = &traces[indexes[j]];
+
+      // check for a full or partial intersection
+      if (tr[j].all_solid || tr[j].fraction < trace->fraction) {
+        *trace = tr[j];
+        trace->ent = (g_entity_t *) ent;
+      }
+    }
+  }
+}
+
 /**
  * @brief Tests a clip of the specified translation against the specified entity.
  */
@@ -558,3 +978,75 @@ cm_trace_t Sv_Clip(const vec3_t start, const vec3_t end, const box3_t bounds,
 
   return trace.trace;
 }
+
+/**
+ * @brief The distance short of the destination at which a visibility trace is still
+ * considered to have reached it, so that points resting on surfaces remain visible.
+ */
+#define SV_VISIBLE_EPSILON 4.f
+
+/**
+ * @return The view origin of the specified client, from which visibility is resolved.
+ */
+vec3_t Sv_ClientViewOrigin(const sv_client_t *cl) {
+
+  const pm_state_t *pm = &cl->gclient->ps.pm_state;
+
+  return Vec3_Add(pm->origin, pm->view_offset);
+}
+
+/**
+ * @return True if `point` is not occluded from `eye` by opaque world geometry.
+ * @remarks Translucent brushes and entities do not occlude.
+ */
+bool Sv_PointVisible(const vec3_t eye, const vec3_t point) {
+
+  const cm_trace_t tr = Cm_BoxTrace(eye, point, Box3_Zero(), 0, CONTENTS_SOLID);
+
+  if (tr.fraction == 1.f) {
+    return true;
+  }
+
+  return Vec3_Distance(tr.end, point) < SV_VISIBLE_EPSILON;
+}
+
+/**
+ * @return The visibility cluster containing `point`, or -1.
+ */
+int32_t Sv_PointCluster(const vec3_t point) {
+  return Cm_LeafCluster(Cm_PointLeafnum(point, 0));
+}
+
+/**
+ * @return True if any of the clusters the entity occupies pass `test` from `cluster`.
+ */
+static bool Sv_EntityInClusterSet(int32_t cluster, const g_entity_t *ent, bool (*test)(int32_t, int32_t)) {
+
+  const sv_entity_t *sent = &sv.entities[ent->s.number];
+
+  if (sent->num_clusters <= 0) {
+    return true;
+  }
+
+  for (int32_t i = 0; i < sent->num_clusters; i++) {
+    if (test(cluster, sent->clusters[i])) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @return True if the entity is potentially visible from `cluster`.
+ */
+bool Sv_EntityInPVS(int32_t cluster, const g_entity_t *ent) {
+  return Sv_EntityInClusterSet(cluster, ent, Cm_ClusterVisible);
+}
+
+/**
+ * @return True if the entity is potentially hearable from `cluster`.
+ */
+bool Sv_EntityInPHS(int32_t cluster, const g_entity_t *ent) {
+  return Sv_EntityInClusterSet(cluster, ent, Cm_ClusterHearable);
+}
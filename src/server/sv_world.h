@@ -31,6 +31,12 @@ size_t Sv_BoxEntities(const box3_t bounds, g_entity_t **list, size_t len, uint32
 int32_t Sv_PointContents(const vec3_t p);
 int32_t Sv_BoxContents(const box3_t bounds);
 cm_trace_t Sv_Trace(const vec3_t start, const vec3_t end, const box3_t bounds, const g_entity_t *skip, int32_t contents);
+void Sv_TraceBatch(const vec3_t *start, const vec3_t *end, size_t count, const box3_t bounds, const g_entity_t *skip, int32_t contents, cm_trace_t *traces);
+vec3_t Sv_ClientViewOrigin(const sv_client_t *cl);
+bool Sv_PointVisible(const vec3_t eye, const vec3_t point);
+int32_t Sv_PointCluster(const vec3_t point);
+bool Sv_EntityInPVS(int32_t cluster, const g_entity_t *ent);
+bool Sv_EntityInPHS(int32_t cluster, const g_entity_t *ent);
 cm_trace_t Sv_Clip(const vec3_t start, const vec3_t end, const box3_t bounds, const g_entity_t *test, int32_t contents);
 
 #endif
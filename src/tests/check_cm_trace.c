@@ -0,0 +1,559 @@
+/*
+ * Copyright(c) 1997-2001 id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quetoo.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "tests.h"
+#include "collision/cm_local.h"
+
+quetoo_t quetoo;
+
+/**
+ * @brief The half-size of the synthetic test world.
+ */
+#define TEST_WORLD_SIZE 1024.f
+
+/**
+ * @brief The depth of the synthetic test world's BSP tree. The world is divided into
+ * `2 ^ TEST_WORLD_DEPTH` cells, each containing a single solid cube.
+ */
+#define TEST_WORLD_DEPTH 9
+
+/**
+ * @brief The maximum number of oblique sides bevelling each cube in the test world.
+ */
+#define TEST_WORLD_BEVELS 6
+
+/**
+ * @brief The number of traces in each test batch.
+ */
+#define TEST_BATCH_SIZE MAX_TRACE_BATCH
+
+/**
+ * @brief Appends an axial plane to the test world.
+ */
+static cm_bsp_plane_t *Test_WorldPlane(int32_t axis, float sign, float dist) {
+
+  vec3_t normal = Vec3_Zero();
+  normal.xyz[axis] = sign;
+
+  cm_bsp_plane_t *plane = &cm_bsp.planes[cm_bsp.num_planes++];
+  *plane = Cm_Plane(normal, dist);
+
+  return plane;
+}
+
+/**
+ * @brief Recursively builds the test world, returning the node or leaf for `bounds`.
+ */
+static int32_t Test_World_r(const box3_t bounds, int32_t depth) {
+
+  const vec3_t center = Box3_Center(bounds);
+
+  if (depth == 0) {
+    const int32_t leaf_num = cm_bsp.num_leafs++;
+    const int32_t brush_num = cm_bsp.num_brushes++;
+
+    const box3_t cube = Box3_FromCenterRadius(center, (bounds.maxs.x - bounds.mins.x) * .25f);
+
+    cm_bsp_brush_t *brush = &cm_bsp.brushes[brush_num];
+    brush->contents = CONTENTS_SOLID;
+    brush->bounds = cube;
+    brush->brush_sides = &cm_bsp.brush_sides[cm_bsp.num_brush_sides];
+    brush->num_brush_sides = 6;
+
+    for (int32_t i = 0; i < 3; i++) {
+      cm_bsp.brush_sides[cm_bsp.num_brush_sides++] = (cm_bsp_brush_side_t) {
+        .plane = Test_WorldPlane(i, 1.f, cube.maxs.xyz[i]),
+        .contents = CONTENTS_SOLID
+      };
+      cm_bsp.brush_sides[cm_bsp.num_brush_sides++] = (cm_bsp_brush_side_t) {
+        .plane = Test_WorldPlane(i, -1.f, -cube.mins.xyz[i]),
+        .contents = CONTENTS_SOLID
+      };
+    }
+
+    // bevel the cube with oblique sides, so that brushes have varying numbers of sides
+    const int32_t bevels = Randomu() % (TEST_WORLD_BEVELS + 1);
+    for (int32_t i = 0; i < bevels; i++) {
+
+      const vec3_t normal = Vec3_RandomDir();
+      const float dist = Vec3_Dot(center, normal) + (cube.maxs.x - center.x) * RandomRangef(.75f, 1.25f);
+
+      cm_bsp_plane_t *plane = &cm_bsp.planes[cm_bsp.num_planes++];
+      *plane = Cm_Plane(normal, dist);
+
+      cm_bsp.brush_sides[cm_bsp.num_brush_sides++] = (cm_bsp_brush_side_t) {
+        .plane = plane,
+        .contents = CONTENTS_SOLID
+      };
+    }
+
+    brush->num_brush_sides += bevels;
+
+    cm_bsp_leaf_t *leaf = &cm_bsp.leafs[leaf_num];
+    leaf->contents = CONTENTS_SOLID;
+    leaf->cluster = -1;
+    leaf->first_leaf_brush = cm_bsp.num_leaf_brushes;
+    leaf->num_leaf_brushes = 1;
+
+    cm_bsp.leaf_brushes[cm_bsp.num_leaf_brushes++] = brush_num;
+
+    return -1 - leaf_num;
+  }
+
+  const int32_t axis = depth % 3;
+  const int32_t node_num = cm_bsp.num_nodes++;
+
+  cm_bsp.nodes[node_num].plane = Test_WorldPlane(axis, 1.f, center.xyz[axis]);
+
+  box3_t front = bounds, back = bounds;
+  front.mins.xyz[axis] = back.maxs.xyz[axis] = center.xyz[axis];
+
+  const int32_t front_num = Test_World_r(front, depth - 1);
+  const int32_t back_num = Test_World_r(back, depth - 1);
+
+  cm_bsp.nodes[node_num].children[0] = front_num;
+  cm_bsp.nodes[node_num].children[1] = back_num;
+
+  return node_num;
+}
+
+/**
+ * @brief Setup fixture. Populates the collision model with a synthetic world, so that
+ * traces do not require a map.
+ */
+void setup(void) {
+
+  Mem_Init();
+
+  Thread_Init(0);
+
+  const int32_t num_leafs = 1 << TEST_WORLD_DEPTH;
+
+  const int32_t max_sides = 6 + TEST_WORLD_BEVELS;
+
+  cm_bsp.planes = Mem_Malloc(sizeof(cm_bsp_plane_t) * (num_leafs * (max_sides + 1) + 12));
+  cm_bsp.nodes = Mem_Malloc(sizeof(cm_bsp_node_t) * (num_leafs + 6));
+  cm_bsp.leafs = Mem_Malloc(sizeof(cm_bsp_leaf_t) * (num_leafs + 1));
+  cm_bsp.leaf_brushes = Mem_Malloc(sizeof(int32_t) * (num_leafs + 1));
+  cm_bsp.brushes = Mem_Malloc(sizeof(cm_bsp_brush_t) * (num_leafs + 1));
+  cm_bsp.brush_sides = Mem_Malloc(sizeof(cm_bsp_brush_side_t) * (num_leafs * max_sides + 6));
+  cm_bsp.brush_planes = Mem_Malloc(sizeof(float) * num_leafs * CM_BRUSH_PLANES(max_sides) * 4);
+
+  Test_World_r(Box3f(TEST_WORLD_SIZE * 2.f, TEST_WORLD_SIZE * 2.f, TEST_WORLD_SIZE * 2.f), TEST_WORLD_DEPTH);
+
+  float *planes = cm_bsp.brush_planes;
+  for (int32_t i = 0; i < cm_bsp.num_brushes; i++) {
+    planes += Cm_PackBrushPlanes(&cm_bsp.brushes[i], planes);
+  }
+
+  cm_bsp.num_brush_planes = (int32_t) (planes - cm_bsp.brush_planes);
+
+  cm_bsp.models = Mem_Malloc(sizeof(cm_bsp_model_t));
+  cm_bsp.models[0].head_node = 0;
+  cm_bsp.models[0].bounds = Box3f(TEST_WORLD_SIZE * 2.f, TEST_WORLD_SIZE * 2.f, TEST_WORLD_SIZE * 2.f);
+  cm_bsp.num_models = 1;
+
+  Cm_InitBvh(&cm_bsp);
+
+  Cm_InitBoxHull(&cm_bsp);
+}
+
+/**
+ * @brief Teardown fixture.
+ */
+void teardown(void) {
+
+  Mem_Free(cm_bsp.planes);
+  Mem_Free(cm_bsp.nodes);
+  Mem_Free(cm_bsp.leafs);
+  Mem_Free(cm_bsp.leaf_brushes);
+  Mem_Free(cm_bsp.brushes);
+  Mem_Free(cm_bsp.brush_sides);
+  Mem_Free(cm_bsp.brush_planes);
+  Mem_Free(cm_bsp.bvh_nodes);
+  Mem_Free(cm_bsp.bvh_brushes);
+  Mem_Free(cm_bsp.bvh_roots);
+  Mem_Free(cm_bsp.models);
+
+  memset(&cm_bsp, 0, sizeof(cm_bsp));
+
+  Cm_SetTraceBackend(CM_TRACE_BSP);
+
+  Thread_Shutdown();
+
+  Mem_Shutdown();
+}
+
+/**
+ * @return A random point within the test world.
+ */
+static vec3_t Test_RandomPoint(void) {
+  return Vec3_RandomRange(-TEST_WORLD_SIZE, TEST_WORLD_SIZE);
+}
+
+/**
+ * @brief Asserts that two traces are identical.
+ */
+static void Test_AssertTraceEqual(const cm_trace_t *a, const cm_trace_t *b) {
+
+  ck_assert(a->all_solid == b->all_solid);
+  ck_assert(a->start_solid == b->start_solid);
+  ck_assert(a->fraction == b->fraction);
+  ck_assert(Vec3_Equal(a->end, b->end));
+  ck_assert(Vec3_Equal(a->plane.normal, b->plane.normal));
+  ck_assert(a->plane.dist == b->plane.dist);
+  ck_assert_int_eq(a->contents, b->contents);
+}
+
+START_TEST(check_Cm_BoxTraceBatch) {
+
+  vec3_t start[TEST_BATCH_SIZE], end[TEST_BATCH_SIZE];
+  cm_trace_t traces[TEST_BATCH_SIZE];
+
+  for (int32_t i = 0; i < 64; i++) {
+
+    const vec3_t origin = Test_RandomPoint();
+    const box3_t bounds = (i & 1) ? Box3_Zero() : Box3f(32.f, 32.f, 56.f);
+
+    const size_t count = 1 + (i * 37) % TEST_BATCH_SIZE;
+
+    for (size_t j = 0; j < count; j++) {
+      start[j] = (i & 2) ? origin : Test_RandomPoint();
+      end[j] = (j % 16) ? Test_RandomPoint() : start[j];
+    }
+
+    Cm_BoxTraceBatch(start, end, count, bounds, 0, CONTENTS_MASK_SOLID, traces);
+
+    for (size_t j = 0; j < count; j++) {
+      const cm_trace_t tr = Cm_BoxTrace(start[j], end[j], bounds, 0, CONTENTS_MASK_SOLID);
+      Test_AssertTraceEqual(&tr, &traces[j]);
+    }
+  }
+
+} END_TEST
+
+START_TEST(check_Cm_TransformedBoxTraceBatch) {
+
+  vec3_t start[TEST_BATCH_SIZE], end[TEST_BATCH_SIZE];
+  cm_trace_t traces[TEST_BATCH_SIZE];
+
+  for (int32_t i = 0; i < 64; i++) {
+
+    const mat4_t matrix = Mat4_FromRotationTranslationScale(Vec3(0.f, i * 15.f, 0.f), Vec3(i * 4.f, 0.f, 0.f), 1.f);
+    const mat4_t inverse_matrix = Mat4_Inverse(matrix);
+
+    const vec3_t origin = Test_RandomPoint();
+
+    for (size_t j = 0; j < TEST_BATCH_SIZE; j++) {
+      start[j] = origin;
+      end[j] = Test_RandomPoint();
+    }
+
+    Cm_TransformedBoxTraceBatch(start, end, TEST_BATCH_SIZE, Box3_Zero(), 0, CONTENTS_MASK_SOLID,
+                                matrix, inverse_matrix, traces);
+
+    for (size_t j = 0; j < TEST_BATCH_SIZE; j++) {
+      const cm_trace_t tr = Cm_TransformedBoxTrace(start[j], end[j], Box3_Zero(), 0, CONTENTS_MASK_SOLID,
+                                                   matrix, inverse_matrix);
+      Test_AssertTraceEqual(&tr, &traces[j]);
+    }
+  }
+
+} END_TEST
+
+/**
+ * @brief Sets or clears the packed planes of every brush in the test world. Brushes without
+ * packed planes are evaluated one side at a time, by the scalar implementation.
+ */
+static void Test_PackWorld(bool packed) {
+
+  float *planes = cm_bsp.brush_planes;
+  for (int32_t i = 0; i < cm_bsp.num_brushes; i++) {
+    cm_bsp_brush_t *brush = &cm_bsp.brushes[i];
+
+    brush->planes = packed ? planes : NULL;
+    planes += CM_BRUSH_PLANES(brush->num_brush_sides) * 4;
+  }
+}
+
+START_TEST(check_Cm_TraceToBrush_Packed) {
+
+  for (int32_t i = 0; i < 10000; i++) {
+
+    const vec3_t start = Test_RandomPoint();
+    const vec3_t end = (i % 16) ? Test_RandomPoint() : start;
+
+    const box3_t bounds = (i & 1) ? Box3_Zero() : Box3(Vec3_RandomRange(-32.f, 0.f), Vec3_RandomRange(0.f, 32.f));
+
+    const mat4_t matrix = Mat4_FromRotationTranslationScale(Vec3_RandomRange(-180.f, 180.f), Vec3_RandomRange(-64.f, 64.f), 1.f);
+    const mat4_t inverse_matrix = Mat4_Inverse(matrix);
+
+    Test_PackWorld(false);
+
+    const cm_trace_t a = Cm_BoxTrace(start, end, bounds, 0, CONTENTS_MASK_SOLID);
+    const cm_trace_t b = Cm_TransformedBoxTrace(start, end, bounds, 0, CONTENTS_MASK_SOLID, matrix, inverse_matrix);
+
+    Test_PackWorld(true);
+
+    const cm_trace_t c = Cm_BoxTrace(start, end, bounds, 0, CONTENTS_MASK_SOLID);
+    const cm_trace_t d = Cm_TransformedBoxTrace(start, end, bounds, 0, CONTENTS_MASK_SOLID, matrix, inverse_matrix);
+
+    Test_AssertTraceEqual(&a, &c);
+    ck_assert_ptr_eq(a.brush_side, c.brush_side);
+
+    Test_AssertTraceEqual(&b, &d);
+    ck_assert_ptr_eq(b.brush_side, d.brush_side);
+
+    const cm_bsp_brush_t *brush = &cm_bsp.brushes[Randomu() % cm_bsp.num_brushes];
+
+    Test_PackWorld(false);
+    const cm_trace_t e = Cm_TraceToBrush(start, end, brush);
+
+    Test_PackWorld(true);
+    const cm_trace_t f = Cm_TraceToBrush(start, end, brush);
+
+    Test_AssertTraceEqual(&e, &f);
+    ck_assert_ptr_eq(e.brush_side, f.brush_side);
+  }
+
+} END_TEST
+
+/**
+ * @brief Microbenchmark of packed brush planes against brush sides evaluated one at a time.
+ */
+START_TEST(check_Cm_TraceToBrush_Benchmark) {
+
+  const int32_t count = 100000;
+
+  vec3_t *start = Mem_Malloc(sizeof(vec3_t) * count);
+  vec3_t *end = Mem_Malloc(sizeof(vec3_t) * count);
+
+  for (int32_t i = 0; i < count; i++) {
+    start[i] = Test_RandomPoint();
+    end[i] = Test_RandomPoint();
+  }
+
+  uint64_t time[2] = { 0, 0 };
+
+  for (int32_t i = 0; i < 2; i++) {
+
+    Test_PackWorld(i == 1);
+
+    const uint64_t begin = SDL_GetTicksNS();
+
+    for (int32_t j = 0; j < count; j++) {
+      const cm_trace_t tr = Cm_BoxTrace(start[j], end[j], Box3f(32.f, 32.f, 56.f), 0, CONTENTS_MASK_SOLID);
+      ck_assert(tr.fraction <= 1.f);
+    }
+
+    time[i] = SDL_GetTicksNS() - begin;
+  }
+
+  printf("%d box traces: scalar %.1f ns, packed %.1f ns per trace\n",
+         count, time[0] / (double) count, time[1] / (double) count);
+
+  Mem_Free(start);
+  Mem_Free(end);
+
+} END_TEST
+
+/**
+ * @brief Microbenchmark of batched traces against individual traces, for fans of rays
+ * cast from a common origin, as from a shotgun blast or a visibility test.
+ */
+START_TEST(check_Cm_BoxTraceBatch_Benchmark) {
+
+  vec3_t start[TEST_BATCH_SIZE], end[TEST_BATCH_SIZE];
+  cm_trace_t traces[TEST_BATCH_SIZE];
+
+  const int32_t rounds = 1000;
+
+  uint64_t individual = 0, batch = 0;
+
+  for (int32_t i = 0; i < rounds; i++) {
+
+    const vec3_t origin = Test_RandomPoint();
+    const vec3_t dir = Vec3_RandomDir();
+
+    for (size_t j = 0; j < TEST_BATCH_SIZE; j++) {
+      start[j] = origin;
+      end[j] = Vec3_Fmaf(origin, TEST_WORLD_SIZE, Vec3_Normalize(Vec3_Fmaf(dir, .25f, Vec3_RandomRange(-1.f, 1.f))));
+    }
+
+    uint64_t time = SDL_GetTicksNS();
+
+    for (size_t j = 0; j < TEST_BATCH_SIZE; j++) {
+      traces[j] = Cm_BoxTrace(start[j], end[j], Box3_Zero(), 0, CONTENTS_MASK_SOLID);
+    }
+
+    individual += SDL_GetTicksNS() - time;
+
+    time = SDL_GetTicksNS();
+
+    Cm_BoxTraceBatch(start, end, TEST_BATCH_SIZE, Box3_Zero(), 0, CONTENTS_MASK_SOLID, traces);
+
+    batch += SDL_GetTicksNS() - time;
+  }
+
+  const double count = rounds * (double) TEST_BATCH_SIZE;
+
+  printf("%d batches of %d traces: individual %.1f ns, batch %.1f ns per trace (%d threads)\n",
+         rounds, TEST_BATCH_SIZE, individual / count, batch / count, Thread_Count());
+
+} END_TEST
+
+START_TEST(check_Cm_BoxTrace_Bvh) {
+
+  vec3_t start[TEST_BATCH_SIZE], end[TEST_BATCH_SIZE];
+  cm_trace_t traces[TEST_BATCH_SIZE];
+
+  for (int32_t i = 0; i < 10000; i++) {
+
+    const vec3_t a = Test_RandomPoint();
+    const vec3_t b = (i % 16) ? Test_RandomPoint() : a;
+
+    const box3_t bounds = (i & 1) ? Box3_Zero() : Box3(Vec3_RandomRange(-32.f, 0.f), Vec3_RandomRange(0.f, 32.f));
+
+    const mat4_t matrix = Mat4_FromRotationTranslationScale(Vec3_RandomRange(-180.f, 180.f), Vec3_RandomRange(-64.f, 64.f), 1.f);
+    const mat4_t inverse_matrix = Mat4_Inverse(matrix);
+
+    // rotated brushes lack axial bevels, so transformed box traces may clip to the brush
+    // planes beyond the brush bounds; only transformed point traces are exact
+    Cm_SetTraceBackend(CM_TRACE_BSP);
+
+    const cm_trace_t c = Cm_BoxTrace(a, b, bounds, 0, CONTENTS_MASK_SOLID);
+    const cm_trace_t d = Cm_TransformedBoxTrace(a, b, Box3_Zero(), 0, CONTENTS_MASK_SOLID, matrix, inverse_matrix);
+
+    Cm_SetTraceBackend(CM_TRACE_BVH);
+
+    const cm_trace_t e = Cm_BoxTrace(a, b, bounds, 0, CONTENTS_MASK_SOLID);
+    const cm_trace_t f = Cm_TransformedBoxTrace(a, b, Box3_Zero(), 0, CONTENTS_MASK_SOLID, matrix, inverse_matrix);
+
+    Test_AssertTraceEqual(&c, &e);
+    ck_assert_ptr_eq(c.brush_side, e.brush_side);
+
+    Test_AssertTraceEqual(&d, &f);
+    ck_assert_ptr_eq(d.brush_side, f.brush_side);
+  }
+
+  for (int32_t i = 0; i < TEST_BATCH_SIZE; i++) {
+    start[i] = Test_RandomPoint();
+    end[i] = Test_RandomPoint();
+  }
+
+  Cm_SetTraceBackend(CM_TRACE_BVH);
+
+  Cm_BoxTraceBatch(start, end, TEST_BATCH_SIZE, Box3f(32.f, 32.f, 56.f), 0, CONTENTS_MASK_SOLID, traces);
+
+  Cm_SetTraceBackend(CM_TRACE_BSP);
+
+  for (int32_t i = 0; i < TEST_BATCH_SIZE; i++) {
+    const cm_trace_t tr = Cm_BoxTrace(start[i], end[i], Box3f(32.f, 32.f, 56.f), 0, CONTENTS_MASK_SOLID);
+    Test_AssertTraceEqual(&tr, &traces[i]);
+  }
+
+} END_TEST
+
+/**
+ * @brief Microbenchmark of the brush bounding volume hierarchy against the BSP tree, for
+ * point and player sized box traces.
+ */
+START_TEST(check_Cm_BoxTrace_Bvh_Benchmark) {
+
+  const int32_t count = 100000;
+
+  vec3_t *start = Mem_Malloc(sizeof(vec3_t) * count);
+  vec3_t *end = Mem_Malloc(sizeof(vec3_t) * count);
+
+  for (int32_t i = 0; i < count; i++) {
+    start[i] = Test_RandomPoint();
+    end[i] = Test_RandomPoint();
+  }
+
+  const box3_t bounds[] = { Box3_Zero(), Box3f(32.f, 32.f, 56.f) };
+  const char *names[] = { "point", "box" };
+
+  for (size_t i = 0; i < lengthof(bounds); i++) {
+
+    uint64_t time[2];
+
+    for (int32_t j = 0; j < 2; j++) {
+
+      Cm_SetTraceBackend(j ? CM_TRACE_BVH : CM_TRACE_BSP);
+
+      const uint64_t begin = SDL_GetTicksNS();
+
+      for (int32_t k = 0; k < count; k++) {
+        const cm_trace_t tr = Cm_BoxTrace(start[k], end[k], bounds[i], 0, CONTENTS_MASK_SOLID);
+        ck_assert(tr.fraction <= 1.f);
+      }
+
+      time[j] = SDL_GetTicksNS() - begin;
+    }
+
+    printf("%d %s traces: bsp %.1f ns, bvh %.1f ns per trace\n",
+           count, names[i], time[0] / (double) count, time[1] / (double) count);
+  }
+
+  Mem_Free(start);
+  Mem_Free(end);
+
+} END_TEST
+
+/**
+ * @brief Test entry point.
+ */
+int32_t main(int32_t argc, char **argv) {
+
+  Test_Init(argc, argv);
+
+  Suite *suite = suite_create("check_cm_trace");
+
+  {
+    TCase *tcase = tcase_create("Cm_BoxTraceBatch");
+    tcase_add_checked_fixture(tcase, setup, teardown);
+    tcase_add_test(tcase, check_Cm_BoxTraceBatch);
+    tcase_add_test(tcase, check_Cm_TransformedBoxTraceBatch);
+    tcase_add_test(tcase, check_Cm_BoxTraceBatch_Benchmark);
+    suite_add_tcase(suite, tcase);
+  }
+
+  {
+    TCase *tcase = tcase_create("Cm_TraceToBrush");
+    tcase_add_checked_fixture(tcase, setup, teardown);
+    tcase_add_test(tcase, check_Cm_TraceToBrush_Packed);
+    tcase_add_test(tcase, check_Cm_TraceToBrush_Benchmark);
+    suite_add_tcase(suite, tcase);
+  }
+
+  {
+    TCase *tcase = tcase_create("Cm_BoxTrace_Bvh");
+    tcase_add_checked_fixture(tcase, setup, teardown);
+    tcase_add_test(tcase, check_Cm_BoxTrace_Bvh);
+    tcase_add_test(tcase, check_Cm_BoxTrace_Bvh_Benchmark);
+    suite_add_tcase(suite, tcase);
+  }
+
+  int32_t failed = Test_Run(suite);
+
+  Test_Shutdown();
+  return failed;
+}
@@ -0,0 +1,318 @@
+/*
+ * Copyright(c) 1997-2001 id Software, Inc.
+ * Copyright(c) 2002 The Quakeforge Project.
+ * Copyright(c) 2006 Quetoo.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include "tests.h"
+
+quetoo_t quetoo;
+
+#define NUM_MESSAGES 4000
+#define TEST_MESSAGE_SIZE 0x400
+
+/**
+ * @brief Setup fixture.
+ */
+void setup(void) {
+
+  Mem_Init();
+
+  Fs_Init(FS_AUTO_LOAD_ARCHIVES);
+}
+
+/**
+ * @brief Teardown fixture.
+ */
+void teardown(void) {
+
+  Fs_Shutdown();
+
+  Mem_Shutdown();
+}
+
+/**
+ * @brief Fills `data` with a repetitive, frame-like message for the given index.
+ */
+static size_t Make_TestMessage(uint32_t index, byte *data) {
+
+  const size_t len = 16 + (index % 240);
+
+  for (size_t i = 0; i < len; i++) {
+    data[i] = (byte) ((i < 8 ? index >> (i & 3) : i) & 0xff);
+  }
+
+  return len;
+}
+
+/**
+ * @return The caller's time at which the test message of the given index is written.
+ */
+static uint32_t Time_TestMessage(uint32_t index) {
+  return 1000 + index * QUETOO_TICK_MILLIS;
+}
+
+/**
+ * @brief Writes `NUM_MESSAGES` test messages to the specified demo, one per frame, with
+ * keyframes as they are due.
+ */
+static void Write_TestDemo(const char *filename, bool compressed) {
+  byte data[TEST_MESSAGE_SIZE];
+
+  demo_t *demo = Demo_OpenWrite(filename, compressed);
+  ck_assert_msg(demo != NULL, "Failed to open %s", filename);
+
+  for (uint32_t i = 0; i < NUM_MESSAGES; i++) {
+    const size_t len = Make_TestMessage(i, data);
+    const uint32_t time = Time_TestMessage(i);
+
+    if (i == 0) {
+      Demo_WriteMessage(demo, data, len, time);
+      Demo_Flush(demo);
+    } else if (Demo_KeyframeDue(demo, time)) {
+      Demo_WriteKeyframe(demo, data, len, time);
+    } else {
+      Demo_WriteMessage(demo, data, len, time);
+    }
+  }
+
+  ck_assert_int_eq(Demo_Tell(demo), NUM_MESSAGES);
+
+  if (compressed) {
+    ck_assert_int_eq(demo->num_keyframes, (NUM_MESSAGES - 2) * QUETOO_TICK_MILLIS / DEMO_KEYFRAME_MILLIS + 1);
+  }
+
+  Demo_Close(demo);
+}
+
+/**
+ * @brief Reads the specified demo from `first` to its end, asserting each message.
+ */
+static void Read_TestDemo(demo_t *demo, uint32_t first) {
+  byte data[TEST_MESSAGE_SIZE], expected[TEST_MESSAGE_SIZE];
+
+  for (uint32_t i = first; i < NUM_MESSAGES; i++) {
+    ck_assert_int_eq(Demo_Tell(demo), i);
+
+    uint32_t time;
+    const int32_t len = Demo_ReadMessage(demo, data, sizeof(data), &time);
+    const size_t expected_len = Make_TestMessage(i, expected);
+
+    ck_assert_int_eq(len, (int32_t) expected_len);
+    ck_assert_msg(!memcmp(data, expected, expected_len), "Message %u differs", i);
+    ck_assert_int_eq(time, Time_TestMessage(i) - Time_TestMessage(0));
+  }
+
+  ck_assert_int_eq(Demo_ReadMessage(demo, data, sizeof(data), NULL), 0);
+}
+
+/**
+ * @brief Seeks the specified demo to a series of times, asserting that each lands on the
+ * nearest preceding keyframe.
+ */
+static void Seek_TestDemo(demo_t *demo) {
+  byte data[TEST_MESSAGE_SIZE];
+
+  const uint32_t times[] = { 60000, 0, 12345, 5025, 99000, 30000 };
+  for (size_t i = 0; i < lengthof(times); i++) {
+    ck_assert(Demo_SeekTime(demo, times[i]));
+
+    uint32_t time;
+    const uint32_t message = Demo_Tell(demo);
+    ck_assert(Demo_ReadMessage(demo, data, sizeof(data), &time) > 0);
+
+    ck_assert_int_eq(time, message * QUETOO_TICK_MILLIS);
+    ck_assert_int_eq(time % DEMO_KEYFRAME_MILLIS, QUETOO_TICK_MILLIS);
+
+    if (times[i] >= QUETOO_TICK_MILLIS) {
+      ck_assert(time <= times[i]);
+      ck_assert(times[i] - time < DEMO_KEYFRAME_MILLIS);
+    } else {
+      ck_assert_int_eq(time, QUETOO_TICK_MILLIS);
+    }
+  }
+
+  ck_assert(Demo_SeekTime(demo, 50000));
+  Read_TestDemo(demo, Demo_Tell(demo));
+}
+
+START_TEST(check_Demo_Compressed) {
+  const char *filename = "demos/check_demo_compressed.demo";
+
+  Write_TestDemo(filename, true);
+
+  demo_t *demo = Demo_OpenRead(filename);
+  ck_assert_msg(demo != NULL, "Failed to open %s", filename);
+  ck_assert(demo->compressed);
+
+  Read_TestDemo(demo, 0);
+
+  Demo_Close(demo);
+} END_TEST
+
+START_TEST(check_Demo_Legacy) {
+  const char *filename = "demos/check_demo_legacy.demo";
+
+  Write_TestDemo(filename, false);
+
+  demo_t *demo = Demo_OpenRead(filename);
+  ck_assert_msg(demo != NULL, "Failed to open %s", filename);
+  ck_assert(!demo->compressed);
+
+  Read_TestDemo(demo, 0);
+
+  Demo_Close(demo);
+} END_TEST
+
+START_TEST(check_Demo_Seek) {
+  const char *filenames[] = {
+    "demos/check_demo_seek_compressed.demo",
+    "demos/check_demo_seek_legacy.demo"
+  };
+
+  for (size_t i = 0; i < lengthof(filenames); i++) {
+    Write_TestDemo(filenames[i], i == 0);
+
+    demo_t *demo = Demo_OpenRead(filenames[i]);
+    ck_assert_msg(demo != NULL, "Failed to open %s", filenames[i]);
+
+    const uint32_t messages[] = { NUM_MESSAGES - 1, NUM_MESSAGES / 2, 1, NUM_MESSAGES * 3 / 4 };
+    for (size_t j = 0; j < lengthof(messages); j++) {
+      ck_assert(Demo_Seek(demo, messages[j]));
+
+      byte data[TEST_MESSAGE_SIZE], expected[TEST_MESSAGE_SIZE];
+
+      const int32_t len = Demo_ReadMessage(demo, data, sizeof(data), NULL);
+      const size_t expected_len = Make_TestMessage(messages[j], expected);
+
+      ck_assert_int_eq(len, (int32_t) expected_len);
+      ck_assert(!memcmp(data, expected, expected_len));
+    }
+
+    ck_assert(Demo_Seek(demo, NUM_MESSAGES / 3));
+    Read_TestDemo(demo, NUM_MESSAGES / 3);
+
+    ck_assert(!Demo_Seek(demo, NUM_MESSAGES + 1));
+
+    Demo_Close(demo);
+  }
+} END_TEST
+
+START_TEST(check_Demo_SeekTime) {
+  const char *filename = "demos/check_demo_seek_time.demo";
+
+  Write_TestDemo(filename, true);
+
+  demo_t *demo = Demo_OpenRead(filename);
+  ck_assert_msg(demo != NULL, "Failed to open %s", filename);
+  ck_assert(demo->num_keyframes > 0);
+
+  Seek_TestDemo(demo);
+
+  Demo_Close(demo);
+} END_TEST
+
+START_TEST(check_Demo_SeekTime_Unindexed) {
+  const char *filename = "demos/check_demo_seek_time_unindexed.demo";
+
+  Write_TestDemo(filename, true);
+
+  // strip the index footer, as though the recording had been interrupted
+  void *buffer;
+  const int64_t len = Fs_Load(filename, &buffer);
+  ck_assert(len > (int64_t) sizeof(demo_index_t));
+
+  file_t *file = Fs_OpenWrite(filename);
+  ck_assert(file != NULL);
+
+  Fs_Write(file, buffer, len - sizeof(demo_index_t), 1);
+  Fs_Close(file);
+  Fs_Free(buffer);
+
+  demo_t *demo = Demo_OpenRead(filename);
+  ck_assert_msg(demo != NULL, "Failed to open %s", filename);
+  ck_assert_int_eq(demo->num_keyframes, 0);
+
+  Seek_TestDemo(demo);
+
+  Demo_Close(demo);
+} END_TEST
+
+START_TEST(check_Demo_SeekTime_Legacy) {
+  const char *filename = "demos/check_demo_seek_time_legacy.demo";
+
+  Write_TestDemo(filename, false);
+
+  demo_t *demo = Demo_OpenRead(filename);
+  ck_assert_msg(demo != NULL, "Failed to open %s", filename);
+
+  ck_assert(Demo_SeekTime(demo, 12345));
+  ck_assert_int_eq(Demo_Tell(demo), 12345 / QUETOO_TICK_MILLIS);
+
+  Read_TestDemo(demo, Demo_Tell(demo));
+
+  Demo_Close(demo);
+} END_TEST
+
+START_TEST(check_Demo_Ratio) {
+  const char *compressed = "demos/check_demo_ratio_compressed.demo";
+  const char *legacy = "demos/check_demo_ratio_legacy.demo";
+
+  Write_TestDemo(compressed, true);
+  Write_TestDemo(legacy, false);
+
+  void *buffer;
+
+  const int64_t compressed_len = Fs_Load(compressed, &buffer);
+  Fs_Free(buffer);
+
+  const int64_t legacy_len = Fs_Load(legacy, &buffer);
+  Fs_Free(buffer);
+
+  ck_assert(compressed_len > 0 && legacy_len > 0);
+  ck_assert_msg(compressed_len * 4 < legacy_len, "%" PRId64 " vs %" PRId64, compressed_len, legacy_len);
+
+  printf("check_Demo_Ratio: %" PRId64 " -> %" PRId64 " bytes\n", legacy_len, compressed_len);
+} END_TEST
+
+/**
+ * @brief Test entry point.
+ */
+int32_t main(int32_t argc, char **argv) {
+
+  Test_Init(argc, argv);
+
+  TCase *tcase = tcase_create("check_demo");
+  tcase_add_checked_fixture(tcase, setup, teardown);
+
+  tcase_add_test(tcase, check_Demo_Compressed);
+  tcase_add_test(tcase, check_Demo_Legacy);
+  tcase_add_test(tcase, check_Demo_Seek);
+  tcase_add_test(tcase, check_Demo_SeekTime);
+  tcase_add_test(tcase, check_Demo_SeekTime_Unindexed);
+  tcase_add_test(tcase, check_Demo_SeekTime_Legacy);
+  tcase_add_test(tcase, check_Demo_Ratio);
+
+  Suite *suite = suite_create("check_demo");
+  suite_add_tcase(suite, tcase);
+
+  int32_t failed = Test_Run(suite);
+
+  Test_Shutdown();
+  return failed;
+}
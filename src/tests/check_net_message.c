@@ -116,6 +116,301 @@ START_TEST(check_PlayerState_Params_DeltaCompressed) {
                 equal.size, diff.size);
 } END_TEST
 
+/**
+ * @brief Quantized positions and velocities must round-trip within half of their
+ * fixed-point resolution, and pack each vector into 8 bytes.
+ */
+START_TEST(check_Position_Quantized) {
+  byte buffer[MAX_MSG_SIZE];
+  mem_buf_t buf;
+  Mem_InitBuffer(&buf, buffer, sizeof(buffer));
+
+  const vec3_t positions[] = {
+    Vec3(0.f, 0.f, 0.f),
+    Vec3(MIN_WORLD_COORD, MAX_WORLD_COORD, -0.015625f),
+    Vec3(1234.567f, -2345.678f, 24.03125f),
+  };
+
+  for (size_t i = 0; i < lengthof(positions); i++) {
+    Net_WritePosition(&buf, positions[i]);
+  }
+
+  ck_assert_int_eq(buf.size, lengthof(positions) * 8);
+
+  const vec3_t velocity = Vec3(-3000.3f, 800.06f, 270.f);
+  Net_WriteVelocity(&buf, velocity);
+
+  buf.read = 0;
+
+  for (size_t i = 0; i < lengthof(positions); i++) {
+    const vec3_t pos = Net_ReadPosition(&buf);
+    for (int32_t j = 0; j < 3; j++) {
+      ck_assert_float_le(fabsf(pos.xyz[j] - positions[i].xyz[j]), .5f / NET_POSITION_SCALE);
+    }
+  }
+
+  const vec3_t vel = Net_ReadVelocity(&buf);
+  for (int32_t j = 0; j < 3; j++) {
+    ck_assert_float_le(fabsf(vel.xyz[j] - velocity.xyz[j]), .5f / NET_VELOCITY_SCALE);
+  }
+} END_TEST
+
+/**
+ * @brief Unchanged stats and inventory should not write their bit masks at all.
+ */
+START_TEST(check_PlayerState_StatsInventory_DeltaCompressed) {
+  byte buffer[MAX_MSG_SIZE];
+  mem_buf_t buf;
+  Mem_InitBuffer(&buf, buffer, sizeof(buffer));
+
+  player_state_t from;
+  memset(&from, 0, sizeof(from));
+
+  player_state_t to = from;
+  to.stats[3] = 100;
+  to.inventory[42] = 7;
+
+  Net_WriteDeltaPlayerState(&buf, &from, &from);
+  ck_assert_int_eq(buf.size, 1);
+
+  Mem_ClearBuffer(&buf);
+
+  Net_WriteDeltaPlayerState(&buf, &from, &to);
+  buf.read = 0;
+
+  player_state_t result;
+  memset(&result, 0, sizeof(result));
+  Net_ReadDeltaPlayerState(&buf, &from, &result);
+
+  ck_assert_int_eq(result.stats[3], 100);
+  ck_assert_int_eq(result.inventory[42], 7);
+  ck_assert_int_eq(buf.read, buf.size);
+} END_TEST
+
+/**
+ * @brief Raw bits, varints, zig-zag varints and bounded integers must all round-trip,
+ * and a bit stream must occupy only as many whole bytes as its bits require.
+ */
+START_TEST(check_Bits_RoundTrip) {
+  byte buffer[MAX_MSG_SIZE];
+  mem_buf_t buf;
+  Mem_InitBuffer(&buf, buffer, sizeof(buffer));
+
+  net_bits_t bits;
+  Net_BeginBits(&bits, &buf);
+
+  Net_WriteBits(&bits, 1, 1);
+  Net_WriteBits(&bits, 5, 3);
+  Net_WriteBits(&bits, 0xdeadbeef, 32);
+  Net_WriteBitsVarInt(&bits, 0);
+  Net_WriteBitsVarInt(&bits, 127);
+  Net_WriteBitsVarInt(&bits, 128);
+  Net_WriteBitsVarInt(&bits, UINT32_MAX);
+  Net_WriteBitsSignedVarInt(&bits, -1);
+  Net_WriteBitsSignedVarInt(&bits, INT32_MIN);
+  Net_WriteBitsSignedVarInt(&bits, INT32_MAX);
+  Net_WriteBitsRange(&bits, 1000, 0, MAX_ENTITIES - 1);
+  Net_WriteBitsRange(&bits, -3, -4, 3);
+  Net_WriteBitsRange(&bits, 100, -4, 3);
+
+  Net_EndBits(&bits);
+
+  Net_WriteByte(&buf, 0x7f);
+
+  // 36 raw bits, 160 bits of varints and 16 bits of ranges pad to 27 bytes
+  ck_assert_int_eq(buf.size, 27 + 1);
+
+  buf.read = 0;
+  Net_BeginReadingBits(&bits, &buf);
+
+  ck_assert_uint_eq(Net_ReadBits(&bits, 1), 1);
+  ck_assert_uint_eq(Net_ReadBits(&bits, 3), 5);
+  ck_assert_uint_eq(Net_ReadBits(&bits, 32), 0xdeadbeef);
+  ck_assert_uint_eq(Net_ReadBitsVarInt(&bits), 0);
+  ck_assert_uint_eq(Net_ReadBitsVarInt(&bits), 127);
+  ck_assert_uint_eq(Net_ReadBitsVarInt(&bits), 128);
+  ck_assert_uint_eq(Net_ReadBitsVarInt(&bits), UINT32_MAX);
+  ck_assert_int_eq(Net_ReadBitsSignedVarInt(&bits), -1);
+  ck_assert_int_eq(Net_ReadBitsSignedVarInt(&bits), INT32_MIN);
+  ck_assert_int_eq(Net_ReadBitsSignedVarInt(&bits), INT32_MAX);
+  ck_assert_int_eq(Net_ReadBitsRange(&bits, 0, MAX_ENTITIES - 1), 1000);
+  ck_assert_int_eq(Net_ReadBitsRange(&bits, -4, 3), -3);
+  ck_assert_int_eq(Net_ReadBitsRange(&bits, -4, 3), 3);
+
+  Net_EndReadingBits(&bits);
+
+  ck_assert_int_eq(Net_ReadByte(&buf), 0x7f);
+  ck_assert_int_eq(buf.read, buf.size);
+} END_TEST
+
+/**
+ * @return A moving, animating entity state for exercising entity deltas.
+ */
+static entity_state_t Make_TestEntity(int32_t i) {
+
+  entity_state_t s;
+  memset(&s, 0, sizeof(s));
+
+  s.number = (int16_t) (1 + i % (MAX_ENTITIES - 1));
+  s.spawn_id = (uint8_t) i;
+  s.origin = Vec3(i * .5f, -i * .25f, 24.f + (i % 64));
+  s.termination = Vec3(-i * .5f, i * .25f, 8.f);
+  s.angles = Vec3(0.f, (i * 7) % 360, 0.f);
+  s.animation1 = (uint8_t) (i % 32);
+  s.animation2 = (uint8_t) (i % 16);
+  s.event = (uint8_t) (i % 8);
+  s.event_data = (uint8_t) i;
+  s.effects = (uint32_t) i << 4;
+  s.trail = (uint8_t) (i % 5);
+  s.model1 = (uint8_t) (i % 255 + 1);
+  s.color.rgba = (uint32_t) i * 2654435761u;
+  s.client = (uint8_t) (i % MAX_CLIENTS);
+  s.sound = (uint8_t) (i % 3);
+  s.solid = SOLID_BOX;
+  s.bounds = Box3(Vec3(-16.f, -16.f, -24.f), Vec3(16.f, 16.f, 32.f));
+  s.step_offset = (int8_t) -(i % 16);
+
+  return s;
+}
+
+/**
+ * @brief Every entity state field must survive a delta round-trip from the null state,
+ * with positions within their fixed-point resolution.
+ */
+START_TEST(check_DeltaEntity_RoundTrip) {
+  byte buffer[MAX_MSG_SIZE];
+  mem_buf_t buf;
+  Mem_InitBuffer(&buf, buffer, sizeof(buffer));
+
+  entity_state_t from;
+  memset(&from, 0, sizeof(from));
+
+  const entity_state_t to = Make_TestEntity(37);
+
+  Net_WriteDeltaEntity(&buf, &from, &to, true);
+  Net_WriteShort(&buf, -1);
+
+  buf.read = 0;
+
+  const int16_t number = Net_ReadShort(&buf);
+  const uint16_t bits = Net_ReadVarInt(&buf);
+
+  entity_state_t result;
+  Net_ReadDeltaEntity(&buf, &from, &result, number, bits);
+
+  ck_assert_int_eq(Net_ReadShort(&buf), -1);
+
+  ck_assert_int_eq(result.number, to.number);
+  ck_assert_int_eq(result.spawn_id, to.spawn_id);
+  ck_assert_float_le(Vec3_Distance(result.origin, to.origin), 1.f / NET_POSITION_SCALE);
+  ck_assert_float_le(Vec3_Distance(result.termination, to.termination), 1.f / NET_POSITION_SCALE);
+  ck_assert_int_eq(result.animation1, to.animation1);
+  ck_assert_int_eq(result.animation2, to.animation2);
+  ck_assert_int_eq(result.event, to.event);
+  ck_assert_int_eq(result.event_data, to.event_data);
+  ck_assert_uint_eq(result.effects, to.effects);
+  ck_assert_int_eq(result.trail, to.trail);
+  ck_assert_int_eq(result.model1, to.model1);
+  ck_assert_uint_eq(result.color.rgba, to.color.rgba);
+  ck_assert_int_eq(result.client, to.client);
+  ck_assert_int_eq(result.sound, to.sound);
+  ck_assert_int_eq(result.solid, to.solid);
+  ck_assert(Box3_Equal(result.bounds, to.bounds));
+  ck_assert_int_eq(result.step_offset, to.step_offset);
+} END_TEST
+
+/**
+ * @brief Movement commands must round-trip, including negative intentions and muzzle offsets.
+ */
+START_TEST(check_DeltaMoveCmd_RoundTrip) {
+  byte buffer[MAX_MSG_SIZE];
+  mem_buf_t buf;
+  Mem_InitBuffer(&buf, buffer, sizeof(buffer));
+
+  pm_cmd_t from;
+  memset(&from, 0, sizeof(from));
+
+  const pm_cmd_t to = {
+    .msec = 25,
+    .angles = Vec3(0.f, 90.f, 0.f),
+    .forward = -300,
+    .right = 150,
+    .up = 0,
+    .buttons = 3,
+    .muzzle = Vec3(12.f, -6.f, 20.f)
+  };
+
+  Net_WriteDeltaMoveCmd(&buf, &from, &to);
+  Net_WriteDeltaMoveCmd(&buf, &to, &to);
+
+  buf.read = 0;
+
+  pm_cmd_t result, unchanged;
+  Net_ReadDeltaMoveCmd(&buf, &from, &result);
+  Net_ReadDeltaMoveCmd(&buf, &result, &unchanged);
+
+  ck_assert_int_eq(result.msec, to.msec);
+  ck_assert_float_le(fabsf(result.angles.y - to.angles.y), .01f);
+  ck_assert_int_eq(result.forward, to.forward);
+  ck_assert_int_eq(result.right, to.right);
+  ck_assert_int_eq(result.up, to.up);
+  ck_assert_int_eq(result.buttons, to.buttons);
+  ck_assert(Vec3_Equal(result.muzzle, to.muzzle));
+  ck_assert(memcmp(&result, &unchanged, sizeof(result)) == 0);
+  ck_assert_int_eq(buf.read, buf.size);
+} END_TEST
+
+/**
+ * @brief Microbenchmark of entity delta encode and decode throughput.
+ */
+START_TEST(check_DeltaEntity_Benchmark) {
+  static byte buffer[MAX_MSG_SIZE * 64];
+  mem_buf_t buf;
+  Mem_InitBuffer(&buf, buffer, sizeof(buffer));
+
+  const int32_t count = 100000;
+
+  entity_state_t *states = Mem_Malloc(sizeof(entity_state_t) * (count + 1));
+  for (int32_t i = 0; i <= count; i++) {
+    states[i] = Make_TestEntity(i);
+  }
+
+  size_t bytes = 0;
+  uint64_t encode = 0, decode = 0;
+
+  for (int32_t i = 0; i < count; i += 1000) {
+
+    Mem_ClearBuffer(&buf);
+
+    uint64_t start = SDL_GetTicksNS();
+
+    for (int32_t j = i; j < i + 1000; j++) {
+      Net_WriteDeltaEntity(&buf, &states[j], &states[j + 1], true);
+    }
+
+    encode += SDL_GetTicksNS() - start;
+    bytes += buf.size;
+
+    start = SDL_GetTicksNS();
+
+    for (int32_t j = i; j < i + 1000; j++) {
+      entity_state_t result;
+      const int16_t number = Net_ReadShort(&buf);
+      const uint16_t bits = Net_ReadVarInt(&buf);
+      Net_ReadDeltaEntity(&buf, &states[j], &result, number, bits);
+    }
+
+    decode += SDL_GetTicksNS() - start;
+
+    ck_assert_int_eq(buf.read, buf.size);
+  }
+
+  printf("%d entity deltas, %.1f bytes each: encode %.1f ns, decode %.1f ns per delta\n",
+         count, bytes / (double) count, encode / (double) count, decode / (double) count);
+
+  Mem_Free(states);
+} END_TEST
+
 /**
  * @brief Test entry point.
  */
@@ -128,6 +423,12 @@ int32_t main(int32_t argc, char **argv) {
 
   tcase_add_test(tcase, check_PlayerState_Params_RoundTrip);
   tcase_add_test(tcase, check_PlayerState_Params_DeltaCompressed);
+  tcase_add_test(tcase, check_Position_Quantized);
+  tcase_add_test(tcase, check_PlayerState_StatsInventory_DeltaCompressed);
+  tcase_add_test(tcase, check_Bits_RoundTrip);
+  tcase_add_test(tcase, check_DeltaEntity_RoundTrip);
+  tcase_add_test(tcase, check_DeltaMoveCmd_RoundTrip);
+  tcase_add_test(tcase, check_DeltaEntity_Benchmark);
 
   Suite *suite = suite_create("check_net_message");
   suite_add_tcase(suite, tcase);